@@ -38,6 +38,8 @@
 #include "SignalHandler.h"
 #include "RealmList.h"
 #include "RealmAcceptor.h"
+#include "AuthWorkerPool.h"
+#include "AuthLoadTest.h"
 
 #ifndef _TRINITY_REALM_CONFIG
 # define _TRINITY_REALM_CONFIG  "authserver.conf"
@@ -70,7 +72,10 @@ public:
 void usage(const char *prog)
 {
     sLog->outInfo(LOG_FILTER_AUTHSERVER, "Usage: \n %s [<options>]\n"
-        "    -c config_file           use config_file as configuration file\n\r",
+        "    -c config_file           use config_file as configuration file\n\r"
+        "    -loadtest logins [connections]\n\r"
+        "                             log in the given number of times through the listening port and report the throughput,\n\r"
+        "                             needs LoadTest.Enabled and a dedicated test login database\n\r",
         prog);
 }
 
@@ -79,6 +84,8 @@ extern int main(int argc, char **argv)
 {
     // Command line parsing to get the configuration file name
     char const* cfg_file = _TRINITY_REALM_CONFIG;
+    uint32 loadTestLogins = 0;
+    uint32 loadTestConnections = 1;
     int c = 1;
     while (c < argc)
     {
@@ -93,6 +100,19 @@ extern int main(int argc, char **argv)
             else
                 cfg_file = argv[c];
         }
+        else if (strcmp(argv[c], "-loadtest") == 0)
+        {
+            if (++c >= argc || atoi(argv[c]) <= 0)
+            {
+                printf("Runtime-Error: -loadtest option requires the number of logins\n");
+                usage(argv[0]);
+                return 1;
+            }
+
+            loadTestLogins = uint32(atoi(argv[c]));
+            if (c + 1 < argc && atoi(argv[c + 1]) > 0)
+                loadTestConnections = uint32(atoi(argv[++c]));
+        }
         ++c;
     }
 
@@ -162,6 +182,32 @@ extern int main(int argc, char **argv)
         return 1;
     }
 
+    // Crypto and database work of the sockets, see AuthSocket::_Defer
+    int32 authWorkerThreads = ConfigMgr::GetIntDefault("AuthWorkerThreads", 2);
+    if (authWorkerThreads < 1 || authWorkerThreads > 32)
+    {
+        sLog->outError(LOG_FILTER_AUTHSERVER, "Improper value specified for AuthWorkerThreads, defaulting to 2.");
+        authWorkerThreads = 2;
+    }
+
+    if (sAuthWorkerPool->Start(size_t(authWorkerThreads)) == -1)
+    {
+        sLog->outError(LOG_FILTER_AUTHSERVER, "Cannot start the auth worker threads");
+        return 1;
+    }
+
+    AuthLoadTest* loadTest = NULL;
+    if (loadTestLogins)
+    {
+        loadTest = new AuthLoadTest(ACE_INET_Addr(uint16(rmport), "127.0.0.1"), loadTestLogins, loadTestConnections);
+        if (!loadTest->Start())
+        {
+            sLog->outError(LOG_FILTER_AUTHSERVER, "Cannot start the load test");
+            delete loadTest;
+            loadTest = NULL;
+        }
+    }
+
     // Initialise the signal handlers
     AuthServerSignalHandler SignalINT, SignalTERM;
 
@@ -221,6 +267,14 @@ extern int main(int argc, char **argv)
         if (ACE_Reactor::instance()->run_reactor_event_loop(interval) == -1)
             break;
 
+        sRealmList->UpdateIfNeed();
+
+        if (loadTest && loadTest->IsFinished())
+        {
+            loadTest->Report();
+            stopEvent = true;
+        }
+
         if ((++loopCounter) == numLoops)
         {
             loopCounter = 0;
@@ -229,6 +283,11 @@ extern int main(int argc, char **argv)
         }
     }
 
+    delete loadTest;
+
+    // Finish the queued tasks before the connections go away
+    sAuthWorkerPool->Stop();
+
     // Close the Database Pool and library
     StopDB();
 
@@ -255,14 +314,14 @@ bool StartDB()
         worker_threads = 1;
     }
 
-    int32 synch_threads = ConfigMgr::GetIntDefault("LoginDatabase.SynchThreads", 1);
+    // every auth worker thread runs synchronous queries
+    int32 synch_threads = ConfigMgr::GetIntDefault("LoginDatabase.SynchThreads", ConfigMgr::GetIntDefault("AuthWorkerThreads", 2));
     if (synch_threads < 1 || synch_threads > 32)
     {
         sLog->outError(LOG_FILTER_AUTHSERVER, "Improper value specified for LoginDatabase.SynchThreads, defaulting to 1.");
         synch_threads = 1;
     }
 
-    // NOTE: While authserver is singlethreaded you should keep synch_threads == 1. Increasing it is just silly since only 1 will be used ever.
     if (!LoginDatabase.Open(dbstring.c_str(), uint8(worker_threads), uint8(synch_threads)))
     {
         sLog->outError(LOG_FILTER_AUTHSERVER, "Cannot connect to database");
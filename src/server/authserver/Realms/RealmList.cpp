@@ -20,7 +20,7 @@
 #include "RealmList.h"
 #include "Database/DatabaseEnv.h"
 
-RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(NULL)) { }
+RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(NULL)), m_updatePending(false) { }
 
 // Load the realm list from the database
 void RealmList::Initialize(uint32 updateInterval)
@@ -53,17 +53,35 @@ void RealmList::UpdateRealm(uint32 id, const std::string& name, ACE_INET_Addr co
 
 void RealmList::UpdateIfNeed()
 {
+    if (m_updatePending)
+    {
+        if (!m_updateResult.ready())
+            return;
+
+        PreparedQueryResult result;
+        m_updateResult.get(result);
+        m_updateResult.cancel();
+        m_updatePending = false;
+
+        // Clears Realm list
+        m_realms.clear();
+
+        LoadRealms(result, false);
+        return;
+    }
+
     // maybe disabled or updated recently
     if (!m_UpdateInterval || m_NextUpdateTime > time(NULL))
         return;
 
     m_NextUpdateTime = time(NULL) + m_UpdateInterval;
 
-    // Clears Realm list
-    m_realms.clear();
+    sLog->outInfo(LOG_FILTER_AUTHSERVER, "Updating Realm List...");
 
     // Get the content of the realmlist table in the database
-    UpdateRealms();
+    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_REALMLIST);
+    m_updateResult = LoginDatabase.AsyncQuery(stmt);
+    m_updatePending = true;
 }
 
 void RealmList::UpdateRealms(bool init)
@@ -71,8 +89,11 @@ void RealmList::UpdateRealms(bool init)
     sLog->outInfo(LOG_FILTER_AUTHSERVER, "Updating Realm List...");
 
     PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_REALMLIST);
-    PreparedQueryResult result = LoginDatabase.Query(stmt);
+    LoadRealms(LoginDatabase.Query(stmt), init);
+}
 
+void RealmList::LoadRealms(PreparedQueryResult result, bool init)
+{
     // Circle through results and add them to the realm map
     if (result)
     {
@@ -23,6 +23,7 @@
 #include <ace/Null_Mutex.h>
 #include <ace/INET_Addr.h>
 #include "Common.h"
+#include "Database/DatabaseEnv.h"
 
 enum RealmFlags
 {
@@ -64,6 +65,8 @@ public:
 
     void Initialize(uint32 updateInterval);
 
+    /// Called by the main loop, reloads the realms with an asynchronous query
+    /// and applies the result on a later call.
     void UpdateIfNeed();
 
     void AddRealm(Realm NewRealm) {m_realms[NewRealm.name] = NewRealm;}
@@ -74,11 +77,15 @@ public:
 
 private:
     void UpdateRealms(bool init=false);
+    void LoadRealms(PreparedQueryResult result, bool init);
     void UpdateRealm(uint32 id, const std::string& name, ACE_INET_Addr const& address, ACE_INET_Addr const& localAddr, ACE_INET_Addr const& localSubmask, uint8 icon, RealmFlags flag, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, uint32 build);
 
     RealmMap m_realms;
     uint32   m_UpdateInterval;
     time_t   m_NextUpdateTime;
+
+    PreparedQueryResultFuture m_updateResult;
+    bool     m_updatePending;
 };
 
 #define sRealmList ACE_Singleton<RealmList, ACE_Null_Mutex>::instance()
@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ace/SOCK_Connector.h>
+#include <ace/SOCK_Stream.h>
+#include <ace/OS_NS_sys_time.h>
+#include <openssl/sha.h>
+#include <openssl/crypto.h>
+
+#include "AuthLoadTest.h"
+#include "AuthCodes.h"
+#include "BigNumber.h"
+#include "ByteBuffer.h"
+#include "Config.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "SHA1.h"
+#include "Util.h"
+
+// client the test logs in with, must be accepted by AuthHelper::IsPostBCAcceptedClientBuild
+#define LOADTEST_CLIENT_BUILD 15595
+
+static ACE_Time_Value const LoadTestTimeout(30);
+
+AuthLoadTest::AuthLoadTest(ACE_INET_Addr const& address, uint32 logins, uint32 connections) :
+    _address(address), _logins(logins), _connections(std::max<uint32>(connections, 1)),
+    _nextLogin(0), _nextThread(0), _finishedThreads(0), _failedLogins(0)
+{
+}
+
+AuthLoadTest::~AuthLoadTest()
+{
+    _nextLogin = long(_logins);
+    wait();
+
+    _RemoveAccounts();
+}
+
+std::string AuthLoadTest::GetAccountName(uint32 index)
+{
+    std::ostringstream ss;
+    ss << "LOADTEST" << index;
+    return ss.str();
+}
+
+// The accounts get a random password for this run only and are removed again by the destructor
+bool AuthLoadTest::_PrepareAccounts()
+{
+    _passwords.resize(_connections);
+
+    for (uint32 i = 0; i < _connections; ++i)
+    {
+        std::string name = GetAccountName(i);
+
+        BigNumber password;
+        password.SetRand(16 * 8);
+        char* passwordHex = password.AsHexStr();
+        _passwords[i] = passwordHex;
+        OPENSSL_free(passwordHex);
+
+        SHA1Hash sha;
+        sha.UpdateData(name);
+        sha.UpdateData(":");
+        sha.UpdateData(_passwords[i]);
+        sha.Finalize();
+
+        std::string hash = ByteArrayToHexStr(sha.GetDigest(), sha.GetLength());
+
+        // v and s are computed again by the first login
+        LoginDatabase.DirectPExecute("INSERT INTO account (username, sha_pass_hash, joindate) VALUES ('%s', '%s', NOW()) "
+            "ON DUPLICATE KEY UPDATE sha_pass_hash = VALUES(sha_pass_hash), v = '', s = '', locked = 0", name.c_str(), hash.c_str());
+    }
+
+    return true;
+}
+
+void AuthLoadTest::_RemoveAccounts()
+{
+    for (uint32 i = 0; i < _passwords.size(); ++i)
+        LoginDatabase.DirectPExecute("DELETE FROM account WHERE username = '%s'", GetAccountName(i).c_str());
+
+    if (!_passwords.empty())
+        sLog->outInfo(LOG_FILTER_AUTHSERVER, "Load test: removed %u test accounts", uint32(_passwords.size()));
+
+    _passwords.clear();
+}
+
+bool AuthLoadTest::Start()
+{
+    // the test accounts must never appear in the login database of a live realm
+    if (!ConfigMgr::GetBoolDefault("LoadTest.Enabled", false))
+    {
+        sLog->outError(LOG_FILTER_AUTHSERVER, "Load test: refusing to create test accounts, set LoadTest.Enabled = 1 "
+            "in the configuration of an authserver using a dedicated test login database");
+        return false;
+    }
+
+    if (!_PrepareAccounts())
+        return false;
+
+    _latencies.reserve(_logins);
+    _startTime = ACE_OS::gettimeofday();
+
+    sLog->outInfo(LOG_FILTER_AUTHSERVER, "Load test: %u logins over %u connections to %s:%u", _logins, _connections,
+        _address.get_host_addr(), _address.get_port_number());
+
+    return activate(THR_NEW_LWP | THR_JOINABLE, int(_connections)) != -1;
+}
+
+int AuthLoadTest::svc()
+{
+    uint32 index = uint32((++_nextThread) - 1);
+    std::string account = GetAccountName(index);
+
+    while (uint32(++_nextLogin) <= _logins)
+    {
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+
+        if (!_Login(account, _passwords[index]))
+        {
+            ++_failedLogins;
+            continue;
+        }
+
+        ACE_Time_Value latency = ACE_OS::gettimeofday() - start;
+
+        TRINITY_GUARD(ACE_Thread_Mutex, _lock);
+        _latencies.push_back(uint32(latency.sec() * 1000000 + latency.usec()));
+    }
+
+    ++_finishedThreads;
+    return 0;
+}
+
+void AuthLoadTest::Report()
+{
+    wait();
+
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - _startTime;
+    double seconds = std::max(elapsed.sec() + elapsed.usec() / 1000000.0, 0.001);
+
+    std::sort(_latencies.begin(), _latencies.end());
+
+    uint32 succeeded = uint32(_latencies.size());
+    uint32 p50 = succeeded ? _latencies[succeeded / 2] : 0;
+    uint32 p99 = succeeded ? _latencies[std::min<uint32>(succeeded * 99 / 100, succeeded - 1)] : 0;
+    uint32 max = succeeded ? _latencies.back() : 0;
+
+    sLog->outInfo(LOG_FILTER_AUTHSERVER, "Load test: %u logins succeeded, %li failed in %.2f s, %.1f logins/s",
+        succeeded, _failedLogins.value(), seconds, succeeded / seconds);
+    sLog->outInfo(LOG_FILTER_AUTHSERVER, "Load test: latency p50 %.2f ms, p99 %.2f ms, max %.2f ms",
+        p50 / 1000.0f, p99 / 1000.0f, max / 1000.0f);
+}
+
+// Logon challenge, logon proof and realm list on a new connection, like the client does
+bool AuthLoadTest::_Login(std::string const& account, std::string const& password)
+{
+    ACE_SOCK_Stream stream;
+    ACE_SOCK_Connector connector;
+
+    if (connector.connect(stream, _address, &LoadTestTimeout) == -1)
+        return false;
+
+    uint8 proof[75];
+    bool result = _Challenge(stream, account, password, proof);
+
+    if (result)
+    {
+        uint8 response[32];
+        result = stream.send_n(proof, sizeof(proof), &LoadTestTimeout) == ssize_t(sizeof(proof)) &&
+            stream.recv_n(response, 2, &LoadTestTimeout) == 2 && response[1] == WOW_SUCCESS &&
+            stream.recv_n(response + 2, sizeof(response) - 2, &LoadTestTimeout) == ssize_t(sizeof(response) - 2);
+    }
+
+    if (result)
+        result = _RealmList(stream);
+
+    stream.close();
+    return result;
+}
+
+// Sends the logon challenge and computes the client side of SRP6 into the proof packet
+bool AuthLoadTest::_Challenge(ACE_SOCK_Stream& stream, std::string const& account, std::string const& password, uint8* proof)
+{
+    ByteBuffer pkt;
+    pkt << uint8(AUTH_LOGON_CHALLENGE);
+    pkt << uint8(6);
+    pkt << uint16(30 + account.size());
+    pkt.append("WoW", 4);                                   // game name
+    pkt << uint8(4) << uint8(3) << uint8(4);                // version
+    pkt << uint16(LOADTEST_CLIENT_BUILD);
+    pkt.append("68x", 4);                                   // platform, byte order reversed
+    pkt.append("niW", 4);                                   // os
+    pkt.append("SUne", 4);                                  // country
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint32(0x0100007F);                              // ip
+    pkt << uint8(account.size());
+    pkt.append(account.c_str(), account.size());
+
+    if (stream.send_n(pkt.contents(), pkt.size(), &LoadTestTimeout) != ssize_t(pkt.size()))
+        return false;
+
+    uint8 header[3];
+    if (stream.recv_n(header, sizeof(header), &LoadTestTimeout) != ssize_t(sizeof(header)) || header[2] != WOW_SUCCESS)
+        return false;
+
+    uint8 bytesB[32], lengthG, bytesG[255], lengthN, bytesN[255], bytesS[32], unk3[16], securityFlags;
+    if (stream.recv_n(bytesB, 32, &LoadTestTimeout) != 32 ||
+        stream.recv_n(&lengthG, 1, &LoadTestTimeout) != 1 ||
+        stream.recv_n(bytesG, lengthG, &LoadTestTimeout) != lengthG ||
+        stream.recv_n(&lengthN, 1, &LoadTestTimeout) != 1 ||
+        stream.recv_n(bytesN, lengthN, &LoadTestTimeout) != lengthN ||
+        stream.recv_n(bytesS, 32, &LoadTestTimeout) != 32 ||
+        stream.recv_n(unk3, 16, &LoadTestTimeout) != 16 ||
+        stream.recv_n(&securityFlags, 1, &LoadTestTimeout) != 1 || securityFlags != 0)
+        return false;
+
+    BigNumber N, g, s, B;
+    N.SetBinary(bytesN, lengthN);
+    g.SetBinary(bytesG, lengthG);
+    s.SetBinary(bytesS, 32);
+    B.SetBinary(bytesB, 32);
+
+    BigNumber a;
+    a.SetRand(19 * 8);
+    BigNumber A = g.ModExp(a, N);
+
+    SHA1Hash sha;
+    sha.UpdateData(account);
+    sha.UpdateData(":");
+    sha.UpdateData(password);
+    sha.Finalize();
+
+    uint8 passwordHash[SHA_DIGEST_LENGTH];
+    memcpy(passwordHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
+    sha.UpdateData(passwordHash, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &B, NULL);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    // S = (B - 3 * g^x) ^ (a + u * x), the server computes the same from A and v
+    BigNumber kgx = (g.ModExp(x, N) * 3) % N;
+    BigNumber S = ((B + N - kgx) % N).ModExp(a + u * x, N);
+
+    // session key and M1 exactly as in AuthSocket::_LogonProofTask
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+
+    BigNumber K;
+    K.SetBinary(vK, 40);
+
+    uint8 hash[20];
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, NULL);
+    sha.Finalize();
+
+    for (int i = 0; i < 20; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(account);
+    sha.Finalize();
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, NULL);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &A, &B, &K, NULL);
+    sha.Finalize();
+
+    // cmd, A, M1, crc hash, number of keys, security flags
+    memset(proof, 0, 75);
+    proof[0] = AUTH_LOGON_PROOF;
+    memcpy(proof + 1, A.AsByteArray(32), 32);
+    memcpy(proof + 33, sha.GetDigest(), 20);
+    return true;
+}
+
+bool AuthLoadTest::_RealmList(ACE_SOCK_Stream& stream)
+{
+    uint8 request[5] = { REALM_LIST, 0, 0, 0, 0 };
+    if (stream.send_n(request, sizeof(request), &LoadTestTimeout) != ssize_t(sizeof(request)))
+        return false;
+
+    uint8 header[3];
+    if (stream.recv_n(header, sizeof(header), &LoadTestTimeout) != ssize_t(sizeof(header)) || header[0] != REALM_LIST)
+        return false;
+
+    std::vector<uint8> body(header[1] | (header[2] << 8));
+    return body.empty() || stream.recv_n(&body[0], body.size(), &LoadTestTimeout) == ssize_t(body.size());
+}
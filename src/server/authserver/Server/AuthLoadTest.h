@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _AUTHLOADTEST_H
+#define _AUTHLOADTEST_H
+
+#include <ace/Task.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/INET_Addr.h>
+
+#include "Common.h"
+
+class ACE_SOCK_Stream;
+
+/// Load generator started by the -loadtest option. Every thread logs in again and again with its own
+/// test account through the listening port, then the logins per second and latencies are reported.
+class AuthLoadTest : protected ACE_Task_Base
+{
+public:
+    AuthLoadTest(ACE_INET_Addr const& address, uint32 logins, uint32 connections);
+    /// Waits for the client threads, they stop after their current login, and removes the test accounts.
+    ~AuthLoadTest();
+
+    /// Creates the test accounts and starts the client threads, only if LoadTest.Enabled is set.
+    bool Start();
+    bool IsFinished() const { return _finishedThreads.value() >= long(_connections); }
+    void Report();
+
+    virtual int svc();
+
+private:
+    typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicCounter;
+
+    static std::string GetAccountName(uint32 index);
+
+    bool _PrepareAccounts();
+    void _RemoveAccounts();
+    bool _Login(std::string const& account, std::string const& password);
+    bool _Challenge(ACE_SOCK_Stream& stream, std::string const& account, std::string const& password, uint8* proof);
+    bool _RealmList(ACE_SOCK_Stream& stream);
+
+    ACE_INET_Addr _address;
+    uint32 _logins;
+    uint32 _connections;
+
+    AtomicCounter _nextLogin;
+    AtomicCounter _nextThread;
+    AtomicCounter _finishedThreads;
+    AtomicCounter _failedLogins;
+
+    std::vector<std::string> _passwords;                    // of the test accounts, by thread index
+
+    ACE_Thread_Mutex _lock;
+    std::vector<uint32> _latencies;                         // microseconds, of the successful logins
+    ACE_Time_Value _startTime;
+};
+
+#endif
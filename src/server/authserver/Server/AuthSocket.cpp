@@ -27,25 +27,12 @@
 #include "RealmList.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
+#include "AuthWorkerPool.h"
 #include "SHA1.h"
 #include "openssl/crypto.h"
 
 #define ChunkSize 2048
 
-enum eAuthCmd
-{
-    AUTH_LOGON_CHALLENGE                         = 0x00,
-    AUTH_LOGON_PROOF                             = 0x01,
-    AUTH_RECONNECT_CHALLENGE                     = 0x02,
-    AUTH_RECONNECT_PROOF                         = 0x03,
-    REALM_LIST                                   = 0x10,
-    XFER_INITIATE                                = 0x30,
-    XFER_DATA                                    = 0x31,
-    XFER_ACCEPT                                  = 0x32,
-    XFER_RESUME                                  = 0x33,
-    XFER_CANCEL                                  = 0x34
-};
-
 enum eStatus
 {
     STATUS_CONNECTED                             = 0,
@@ -196,7 +183,7 @@ const AuthHandler table[] =
 Patcher PatchesCache;
 
 // Constructor - set the N and g values for SRP6
-AuthSocket::AuthSocket(RealmSocket& socket) : pPatch(NULL), socket_(socket)
+AuthSocket::AuthSocket(RealmSocket& socket) : pPatch(NULL), socket_(socket), _task(NULL), _taskFinish(NULL), _taskShutdown(false), _accountId(0)
 {
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
@@ -224,6 +211,10 @@ void AuthSocket::OnRead()
     uint8 _cmd;
     while (1)
     {
+        // the next command waits for the running task, see OnTaskDone
+        if (_task)
+            return;
+
         if (!socket().recv_soft((char *)&_cmd, 1))
             return;
 
@@ -255,6 +246,61 @@ void AuthSocket::OnRead()
     }
 }
 
+bool AuthSocket::_Defer(TaskHandler task, TaskHandler finish)
+{
+    _task = task;
+    _taskFinish = finish;
+
+    // released by RunTask, the task may still run when the client disconnects
+    socket().add_reference();
+    sAuthWorkerPool->Schedule(this);
+    return true;
+}
+
+void AuthSocket::RunTask(void)
+{
+    RealmSocket& sock = socket();
+
+    (this->*_task)();
+
+    // OnTaskDone is called from the reactor thread, which holds its own reference meanwhile
+    if (sock.reactor()->notify(&sock, ACE_Event_Handler::EXCEPT_MASK) == -1)
+        sLog->outError(LOG_FILTER_AUTHSERVER, "'%s:%d' AuthSocket::RunTask: failed to notify the reactor", sock.getRemoteAddress().c_str(), sock.getRemotePort());
+
+    sock.remove_reference();
+}
+
+void AuthSocket::OnTaskDone(void)
+{
+    TaskHandler finish = _taskFinish;
+    _task = NULL;
+    _taskFinish = NULL;
+
+    if (!_taskOutput.empty())
+    {
+        socket().send((char const*)_taskOutput.contents(), _taskOutput.size());
+        _taskOutput.clear();
+    }
+
+    if (_taskShutdown)
+    {
+        _taskShutdown = false;
+        socket().shutdown();
+        return;
+    }
+
+    if (finish)
+        (this->*finish)();
+
+    // continue with the commands received meanwhile
+    OnRead();
+}
+
+void AuthSocket::_Send(void const* data, size_t len)
+{
+    _taskOutput.append((uint8 const*)data, len);
+}
+
 // Make the SRP6 calculation from hash in dB
 void AuthSocket::_SetVSFields(const std::string& rI)
 {
@@ -339,8 +385,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->ip);
 #endif
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
     _expversion = uint8(AuthHelper::IsPostBCAcceptedClientBuild(_build) ? POST_BC_EXP_FLAG : (AuthHelper::IsPreBCAcceptedClientBuild(_build) ? PRE_BC_EXP_FLAG : NO_VALID_EXP_FLAG));
@@ -352,6 +396,18 @@ bool AuthSocket::_HandleLogonChallenge()
     // Restore string order as its byte order is reversed
     std::reverse(_os.begin(), _os.end());
 
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4-i-1];
+
+    return _Defer(&AuthSocket::_LogonChallengeTask);
+}
+
+// Database and SRP6 part of the logon challenge, runs on a worker thread
+void AuthSocket::_LogonChallengeTask()
+{
+    ByteBuffer pkt;
+
     pkt << uint8(AUTH_LOGON_CHALLENGE);
     pkt << uint8(0x00);
 
@@ -487,12 +543,8 @@ bool AuthSocket::_HandleLogonChallenge()
                     uint8 secLevel = fields[4].GetUInt8();
                     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
 
-                    _localizationName.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                        _localizationName[i] = ch->country[4-i-1];
-
-                    sLog->outDebug(LOG_FILTER_AUTHSERVER, "'%s:%d' [AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", socket().getRemoteAddress().c_str(), socket().getRemotePort(),
-                            _login.c_str (), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName)
+                    sLog->outDebug(LOG_FILTER_AUTHSERVER, "'%s:%d' [AuthChallenge] account %s is using '%s' locale (%u)", socket().getRemoteAddress().c_str(), socket().getRemotePort(),
+                            _login.c_str (), _localizationName.c_str(), GetLocaleByName(_localizationName)
                         );
                 }
             }
@@ -501,8 +553,7 @@ bool AuthSocket::_HandleLogonChallenge()
             pkt << (uint8)WOW_FAIL_UNKNOWN_ACCOUNT;
     }
 
-    socket().send((char const*)pkt.contents(), pkt.size());
-    return true;
+    _Send(pkt.contents(), pkt.size());
 }
 
 // Logon Proof command handler
@@ -525,8 +576,6 @@ bool AuthSocket::_HandleLogonProof()
     }
 
     // Continue the SRP6 calculation based on data received from the client
-    BigNumber A;
-
     A.SetBinary(lp.A, 32);
 
     // SRP safeguard: abort if A == 0
@@ -536,6 +585,14 @@ bool AuthSocket::_HandleLogonProof()
         return true;
     }
 
+    memcpy(_clientM1, lp.M1, 20);
+
+    return _Defer(&AuthSocket::_LogonProofTask);
+}
+
+// SRP6 and database part of the logon proof, runs on a worker thread
+void AuthSocket::_LogonProofTask()
+{
     SHA1Hash sha;
     sha.UpdateBigNumbers(&A, &B, NULL);
     sha.Finalize();
@@ -601,7 +658,7 @@ bool AuthSocket::_HandleLogonProof()
     M.SetBinary(sha.GetDigest(), 20);
 
     // Check if SRP6 results match (password is correct), else send an error
-    if (!memcmp(M.AsByteArray(), lp.M1, 20))
+    if (!memcmp(M.AsByteArray(), _clientM1, 20))
     {
         sLog->outDebug(LOG_FILTER_AUTHSERVER, "'%s:%d' User '%s' successfully authenticated", socket().getRemoteAddress().c_str(), socket().getRemotePort(), _login.c_str());
 
@@ -633,7 +690,7 @@ bool AuthSocket::_HandleLogonProof()
             proof.unk1 = 0x00800000;    // Accountflags. 0x01 = GM, 0x08 = Trial, 0x00800000 = Pro pass (arena tournament)
             proof.unk2 = 0x00;          // SurveyId
             proof.unk3 = 0x00;
-            socket().send((char *)&proof, sizeof(proof));
+            _Send(&proof, sizeof(proof));
         }
         else
         {
@@ -642,7 +699,7 @@ bool AuthSocket::_HandleLogonProof()
             proof.cmd = AUTH_LOGON_PROOF;
             proof.error = 0;
             proof.unk2 = 0x00;
-            socket().send((char *)&proof, sizeof(proof));
+            _Send(&proof, sizeof(proof));
         }
 
         _authed = true;
@@ -650,7 +707,7 @@ bool AuthSocket::_HandleLogonProof()
     else
     {
         char data[4] = { AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0 };
-        socket().send(data, sizeof(data));
+        _Send(data, sizeof(data));
 
         sLog->outDebug(LOG_FILTER_AUTHSERVER, "'%s:%d' [AuthChallenge] account %s tried to login with invalid password!", socket().getRemoteAddress().c_str(), socket().getRemotePort(), _login.c_str ());
 
@@ -699,8 +756,6 @@ bool AuthSocket::_HandleLogonProof()
             }
         }
     }
-
-    return true;
 }
 
 // Reconnect Challenge command handler
@@ -738,18 +793,6 @@ bool AuthSocket::_HandleReconnectChallenge()
 
     _login = (const char*)ch->I;
 
-    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_SESSIONKEY);
-    stmt->setString(0, _login);
-    PreparedQueryResult result = LoginDatabase.Query(stmt);
-
-    // Stop if the account is not found
-    if (!result)
-    {
-        sLog->outError(LOG_FILTER_AUTHSERVER, "'%s:%d' [ERROR] user %s tried to login and we cannot find his session key in the database.", socket().getRemoteAddress().c_str(), socket().getRemotePort(), _login.c_str());
-        socket().shutdown();
-        return false;
-    }
-
     // Reinitialize build, expansion and the account securitylevel
     _build = ch->build;
     _expversion = uint8(AuthHelper::IsPostBCAcceptedClientBuild(_build) ? POST_BC_EXP_FLAG : (AuthHelper::IsPreBCAcceptedClientBuild(_build) ? PRE_BC_EXP_FLAG : NO_VALID_EXP_FLAG));
@@ -761,6 +804,24 @@ bool AuthSocket::_HandleReconnectChallenge()
     // Restore string order as its byte order is reversed
     std::reverse(_os.begin(), _os.end());
 
+    return _Defer(&AuthSocket::_ReconnectChallengeTask);
+}
+
+// Database part of the reconnect challenge, runs on a worker thread
+void AuthSocket::_ReconnectChallengeTask()
+{
+    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_SESSIONKEY);
+    stmt->setString(0, _login);
+    PreparedQueryResult result = LoginDatabase.Query(stmt);
+
+    // Stop if the account is not found
+    if (!result)
+    {
+        sLog->outError(LOG_FILTER_AUTHSERVER, "'%s:%d' [ERROR] user %s tried to login and we cannot find his session key in the database.", socket().getRemoteAddress().c_str(), socket().getRemotePort(), _login.c_str());
+        _Shutdown();
+        return;
+    }
+
     Field* fields = result->Fetch();
     uint8 secLevel = fields[2].GetUInt8();
     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
@@ -774,8 +835,7 @@ bool AuthSocket::_HandleReconnectChallenge()
     _reconnectProof.SetRand(16 * 8);
     pkt.append(_reconnectProof.AsByteArray(16), 16);        // 16 bytes random
     pkt << uint64(0x00) << uint64(0x00);                    // 16 bytes zeros
-    socket().send((char const*)pkt.contents(), pkt.size());
-    return true;
+    _Send(pkt.contents(), pkt.size());
 }
 
 // Reconnect Proof command handler
@@ -849,6 +909,17 @@ bool AuthSocket::_HandleRealmList()
 
     socket().recv_skip(5);
 
+    // Characters are counted on the realms known now, the realm list is reloaded by the main loop only
+    _realmCharacters.clear();
+    for (RealmList::RealmMap::const_iterator i = sRealmList->begin(); i != sRealmList->end(); ++i)
+        _realmCharacters[i->second.m_ID] = 0;
+
+    return _Defer(&AuthSocket::_RealmListTask, &AuthSocket::_RealmListFinish);
+}
+
+// Database part of the realm list, runs on a worker thread
+void AuthSocket::_RealmListTask()
+{
     // Get the user id (else close the connection)
     // No SQL injection (prepared statement)
     PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_ACCOUNT_ID_BY_NAME);
@@ -857,16 +928,27 @@ bool AuthSocket::_HandleRealmList()
     if (!result)
     {
         sLog->outError(LOG_FILTER_AUTHSERVER, "'%s:%d' [ERROR] user %s tried to login but we cannot find him in the database.", socket().getRemoteAddress().c_str(), socket().getRemotePort(), _login.c_str());
-        socket().shutdown();
-        return false;
+        _Shutdown();
+        return;
     }
 
     Field* fields = result->Fetch();
-    uint32 id = fields[0].GetUInt32();
+    _accountId = fields[0].GetUInt32();
 
-    // Update realm list if need
-    sRealmList->UpdateIfNeed();
+    for (std::map<uint32, uint8>::iterator itr = _realmCharacters.begin(); itr != _realmCharacters.end(); ++itr)
+    {
+        stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_NUM_CHARS_ON_REALM);
+        stmt->setUInt32(0, itr->first);
+        stmt->setUInt32(1, _accountId);
+        result = LoginDatabase.Query(stmt);
+        if (result)
+            itr->second = (*result)[0].GetUInt8();
+    }
+}
 
+// Send the realm list with the characters counted by _RealmListTask
+void AuthSocket::_RealmListFinish()
+{
     ACE_INET_Addr clientAddr;
     socket().peer().get_remote_addr(clientAddr);
 
@@ -907,12 +989,9 @@ bool AuthSocket::_HandleRealmList()
         uint8 lock = (i->second.allowedSecurityLevel > _accountSecurityLevel) ? 1 : 0;
 
         uint8 AmountOfCharacters = 0;
-        stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_NUM_CHARS_ON_REALM);
-        stmt->setUInt32(0, i->second.m_ID);
-        stmt->setUInt32(1, id);
-        result = LoginDatabase.Query(stmt);
-        if (result)
-            AmountOfCharacters = (*result)[0].GetUInt8();
+        std::map<uint32, uint8>::const_iterator characters = _realmCharacters.find(i->second.m_ID);
+        if (characters != _realmCharacters.end())
+            AmountOfCharacters = characters->second;
 
         pkt << i->second.icon;                              // realm type
         if (_expversion & POST_BC_EXP_FLAG)                 // only 2.x and 3.x clients
@@ -965,8 +1044,6 @@ bool AuthSocket::_HandleRealmList()
     hdr.append(pkt);                                        // append realms in the realmlist
 
     socket().send((char const*)hdr.contents(), hdr.size());
-
-    return true;
 }
 
 // Resume patch transfer
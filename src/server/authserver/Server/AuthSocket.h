@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "BigNumber.h"
+#include "ByteBuffer.h"
 #include "RealmSocket.h"
 
 class ACE_INET_Addr;
@@ -38,6 +39,10 @@ public:
     virtual void OnRead(void);
     virtual void OnAccept(void);
     virtual void OnClose(void);
+    virtual void OnTaskDone(void);
+
+    /// Called by AuthWorkerPool on a worker thread.
+    void RunTask(void);
 
     static ACE_INET_Addr const& GetAddressForClient(Realm const& realm, ACE_INET_Addr const& clientAddr);
 
@@ -58,17 +63,45 @@ public:
     ACE_Thread_Mutex patcherLock;
 
 private:
+    typedef void (AuthSocket::*TaskHandler)(void);
+
+    /// Run task on a worker thread, the commands received meanwhile stay in the input buffer.
+    /// finish is called on the reactor thread afterwards, unless the task shut the socket down.
+    bool _Defer(TaskHandler task, TaskHandler finish = NULL);
+
+    /// Used by the tasks instead of socket().send() and socket().shutdown(), see OnTaskDone.
+    void _Send(void const* data, size_t len);
+    void _Shutdown(void) { _taskShutdown = true; }
+
+    void _LogonChallengeTask(void);
+    void _LogonProofTask(void);
+    void _ReconnectChallengeTask(void);
+    void _RealmListTask(void);
+    void _RealmListFinish(void);
+
     RealmSocket& socket_;
     RealmSocket& socket(void) { return socket_; }
 
+    TaskHandler _task;
+    TaskHandler _taskFinish;
+    ByteBuffer _taskOutput;
+    bool _taskShutdown;
+
     BigNumber N, s, g, v;
+    BigNumber A;
     BigNumber b, B;
     BigNumber K;
     BigNumber _reconnectProof;
 
     bool _authed;
 
+    uint8 _clientM1[20];
+
     std::string _login;
+    uint32 _accountId;
+
+    // characters of the account per realm id, queried for the realm list
+    std::map<uint32, uint8> _realmCharacters;
 
     // Since GetLocaleByName() is _NOT_ bijective, we have to store the locale as a string. Otherwise we can't differ
     // between enUS and enGB, which is important for the patch system
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuthWorkerPool.h"
+#include "AuthSocket.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+AuthWorkerPool::AuthWorkerPool() : _condition(_lock), _threads(0), _stopping(false) { }
+
+AuthWorkerPool::~AuthWorkerPool()
+{
+    Stop();
+}
+
+int AuthWorkerPool::Start(size_t threads)
+{
+    if (_threads || threads < 1)
+        return -1;
+
+    _stopping = false;
+
+    if (activate(THR_NEW_LWP | THR_JOINABLE, int(threads)) == -1)
+        return -1;
+
+    _threads = threads;
+    return 0;
+}
+
+void AuthWorkerPool::Stop()
+{
+    if (!_threads)
+        return;
+
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, _lock);
+        _stopping = true;
+        _condition.broadcast();
+    }
+
+    wait();
+    _threads = 0;
+}
+
+void AuthWorkerPool::Schedule(AuthSocket* session)
+{
+    TRINITY_GUARD(ACE_Thread_Mutex, _lock);
+    _queue.push_back(session);
+    _condition.signal();
+}
+
+size_t AuthWorkerPool::GetQueueSize()
+{
+    TRINITY_GUARD(ACE_Thread_Mutex, _lock);
+    return _queue.size();
+}
+
+int AuthWorkerPool::svc()
+{
+    MySQL::Thread_Init();
+
+    for (;;)
+    {
+        AuthSocket* session = NULL;
+
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, _lock);
+
+            // finish the queued tasks before stopping, their sockets wait for them
+            while (_queue.empty() && !_stopping)
+                _condition.wait();
+
+            if (_queue.empty())
+                break;
+
+            session = _queue.front();
+            _queue.pop_front();
+        }
+
+        session->RunTask();
+    }
+
+    MySQL::Thread_End();
+    return 0;
+}
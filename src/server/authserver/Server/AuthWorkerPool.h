@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include <ace/Task.h>
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <deque>
+
+#include "Common.h"
+
+class AuthSocket;
+
+/// Runs the database queries and SRP6 calculations of AuthSocket commands, so
+/// the reactor thread only does socket I/O. See AuthSocket::_Defer.
+class AuthWorkerPool : protected ACE_Task_Base
+{
+    friend class ACE_Singleton<AuthWorkerPool, ACE_Thread_Mutex>;
+
+public:
+    int Start(size_t threads);
+    void Stop();
+
+    /// Queue the pending task of the session, called from the reactor thread.
+    void Schedule(AuthSocket* session);
+
+    size_t GetQueueSize();
+    size_t GetThreadCount() const { return _threads; }
+
+    virtual int svc();
+
+private:
+    AuthWorkerPool();
+    ~AuthWorkerPool();
+
+    std::deque<AuthSocket*> _queue;
+    ACE_Thread_Mutex _lock;
+    ACE_Condition_Thread_Mutex _condition;
+    size_t _threads;
+    bool _stopping;
+};
+
+#define sAuthWorkerPool ACE_Singleton<AuthWorkerPool, ACE_Thread_Mutex>::instance()
+
+#endif
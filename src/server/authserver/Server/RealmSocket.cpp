@@ -241,6 +241,21 @@ int RealmSocket::handle_output(ACE_HANDLE)
     ACE_NOTREACHED(return -1);
 }
 
+int RealmSocket::handle_exception(ACE_HANDLE)
+{
+    // the client went away while the task was running
+    if (closing_)
+        return 0;
+
+    if (session_ != NULL)
+    {
+        session_->OnTaskDone();
+        input_buffer_.crunch();
+    }
+
+    return 0;
+}
+
 int RealmSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
 {
     // As opposed to WorldSocket::handle_close, we don't need locks here.
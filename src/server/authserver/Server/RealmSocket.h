@@ -41,6 +41,9 @@ public:
         virtual void OnRead(void) = 0;
         virtual void OnAccept(void) = 0;
         virtual void OnClose(void) = 0;
+
+        /// Called on the reactor thread once a worker thread finished the task of the session.
+        virtual void OnTaskDone(void) = 0;
     };
 
     RealmSocket(void);
@@ -64,6 +67,9 @@ public:
     virtual int handle_input(ACE_HANDLE = ACE_INVALID_HANDLE);
     virtual int handle_output(ACE_HANDLE = ACE_INVALID_HANDLE);
 
+    /// Called for ACE_Reactor::notify() by the worker threads of AuthWorkerPool.
+    virtual int handle_exception(ACE_HANDLE = ACE_INVALID_HANDLE);
+
     virtual int handle_close(ACE_HANDLE = ACE_INVALID_HANDLE, ACE_Reactor_Mask = ACE_Event_Handler::ALL_EVENTS_MASK);
 
     void set_session(Session* session);
@@ -644,7 +644,7 @@ void AchievementMgr<Guild>::SaveToDB(SQLTransaction& trans)
 {
     PreparedStatement* stmt;
     std::ostringstream guidstr;
-    for (CompletedAchievementMap::const_iterator itr = m_completedAchievements.begin(); itr != m_completedAchievements.end(); ++itr)
+    for (CompletedAchievementMap::iterator itr = m_completedAchievements.begin(); itr != m_completedAchievements.end(); ++itr)
     {
         if (!itr->second.changed)
             continue;
@@ -665,9 +665,12 @@ void AchievementMgr<Guild>::SaveToDB(SQLTransaction& trans)
         trans->Append(stmt);
 
         guidstr.str("");
+
+        /// mark as saved in db
+        itr->second.changed = false;
     }
 
-    for (CriteriaProgressMap::const_iterator itr = m_criteriaProgress.begin(); itr != m_criteriaProgress.end(); ++itr)
+    for (CriteriaProgressMap::iterator itr = m_criteriaProgress.begin(); itr != m_criteriaProgress.end(); ++itr)
     {
         if (!itr->second.changed)
             continue;
@@ -684,6 +687,9 @@ void AchievementMgr<Guild>::SaveToDB(SQLTransaction& trans)
         stmt->setUInt32(3, itr->second.date);
         stmt->setUInt32(4, GUID_LOPART(itr->second.CompletedGUID));
         trans->Append(stmt);
+
+        /// mark as saved in db
+        itr->second.changed = false;
     }
 }
 
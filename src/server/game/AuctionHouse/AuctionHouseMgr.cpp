@@ -37,7 +37,7 @@ enum eAuctionHouse
     AH_MINIMUM_DEPOSIT = 100
 };
 
-AuctionHouseMgr::AuctionHouseMgr()
+AuctionHouseMgr::AuctionHouseMgr() : _expiryBacklog(false)
 {
 }
 
@@ -361,9 +361,10 @@ bool AuctionHouseMgr::RemoveAItem(uint32 id)
 
 void AuctionHouseMgr::Update()
 {
-    mHordeAuctions.Update();
-    mAllianceAuctions.Update();
-    mNeutralAuctions.Update();
+    bool backlog = mHordeAuctions.Update();
+    backlog |= mAllianceAuctions.Update();
+    backlog |= mNeutralAuctions.Update();
+    _expiryBacklog = backlog;
 }
 
 AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(uint32 factionTemplateId)
@@ -411,12 +412,16 @@ void AuctionHouseObject::AddAuction(AuctionEntry* auction)
     ASSERT(auction);
 
     AuctionsMap[auction->Id] = auction;
+    _expiryIndex.insert(std::make_pair(auction->expire_time, auction->Id));
+    AddToSearchIndex(auction);
     sScriptMgr->OnAuctionAdd(this, auction);
 }
 
 bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction, uint32 /*itemEntry*/)
 {
     bool wasInMap = AuctionsMap.erase(auction->Id) ? true : false;
+    _expiryIndex.erase(std::make_pair(auction->expire_time, auction->Id));
+    RemoveFromSearchIndex(auction->Id);
 
     sScriptMgr->OnAuctionRemove(this, auction);
 
@@ -427,59 +432,60 @@ bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction, uint32 /*itemEntry
     return wasInMap;
 }
 
-void AuctionHouseObject::Update()
+bool AuctionHouseObject::Update()
 {
-    time_t curTime = sWorld->GetGameTime();
-    ///- Handle expired auctions
+    ///- Handle expired auctions, including the ones expiring within the next minute
+    time_t expireTime = sWorld->GetGameTime() + MINUTE;
 
-    // If storage is empty, no need to update. next == NULL in this case.
-    if (AuctionsMap.empty())
-        return;
+    uint32 expired = 0;
+    while (!_expiryIndex.empty() && _expiryIndex.begin()->first <= expireTime)
+    {
+        if (expired >= AUCTION_EXPIRE_PER_UPDATE)
+            return true;
 
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_AUCTION_BY_TIME);
-    stmt->setUInt32(0, (uint32)curTime+60);
-    PreparedQueryResult result = CharacterDatabase.Query(stmt);
+        ///- The mails and deletions of a batch of auctions share one transaction
+        SQLTransaction trans = CharacterDatabase.BeginTransaction();
 
-    if (!result)
-        return;
+        for (uint32 i = 0; i < AUCTION_EXPIRE_BATCH_SIZE && !_expiryIndex.empty() && _expiryIndex.begin()->first <= expireTime; ++i)
+        {
+            AuctionEntry* auction = GetAuction(_expiryIndex.begin()->second);
+            if (!auction)
+            {
+                _expiryIndex.erase(_expiryIndex.begin());
+                continue;
+            }
 
-    do
-    {
-        // from auctionhousehandler.cpp, creates auction pointer & player pointer
-        AuctionEntry* auction = GetAuction(result->Fetch()->GetUInt32());
+            ///- Either cancel the auction if there was no bidder
+            if (auction->bidder == 0)
+            {
+                sAuctionMgr->SendAuctionExpiredMail(auction, trans);
+                sScriptMgr->OnAuctionExpire(this, auction);
+            }
+            ///- Or perform the transaction
+            else
+            {
+                //we should send an "item sold" message if the seller is online
+                //we send the item to the winner
+                //we send the money to the seller
+                sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
+                sAuctionMgr->SendAuctionWonMail(auction, trans);
+                sScriptMgr->OnAuctionSuccessful(this, auction);
+            }
 
-        if (!auction)
-            continue;
+            uint32 itemEntry = auction->itemEntry;
 
-        SQLTransaction trans = CharacterDatabase.BeginTransaction();
+            ///- In any case clear the auction
+            auction->DeleteFromDB(trans);
 
-        ///- Either cancel the auction if there was no bidder
-        if (auction->bidder == 0)
-        {
-            sAuctionMgr->SendAuctionExpiredMail(auction, trans);
-            sScriptMgr->OnAuctionExpire(this, auction);
+            sAuctionMgr->RemoveAItem(auction->itemGUIDLow);
+            RemoveAuction(auction, itemEntry);
+            ++expired;
         }
-        ///- Or perform the transaction
-        else
-        {
-            //we should send an "item sold" message if the seller is online
-            //we send the item to the winner
-            //we send the money to the seller
-            sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
-            sAuctionMgr->SendAuctionWonMail(auction, trans);
-            sScriptMgr->OnAuctionSuccessful(this, auction);
-        }
-
-        uint32 itemEntry = auction->itemEntry;
 
-        ///- In any case clear the auction
-        auction->DeleteFromDB(trans);
         CharacterDatabase.CommitTransaction(trans);
-
-        sAuctionMgr->RemoveAItem(auction->itemGUIDLow);
-        RemoveAuction(auction, itemEntry);
     }
-    while (result->NextRow());
+
+    return false;
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
@@ -512,83 +518,241 @@ void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player,
     }
 }
 
+void AuctionHouseObject::AddToSearchIndex(AuctionEntry* auction)
+{
+    Item* item = sAuctionMgr->GetAItem(auction->itemGUIDLow);
+    if (!item)
+        return;
+
+    ItemTemplate const* proto = item->GetTemplate();
+
+    AuctionSearchInfo& info = _searchInfo[auction->Id];
+    info.auction = auction;
+    info.itemClass = proto->Class;
+    info.itemSubClass = proto->SubClass;
+    info.inventoryType = proto->InventoryType;
+    info.quality = proto->Quality;
+    info.requiredLevel = proto->RequiredLevel;
+    // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
+    //  that matches the search but it may not equal item->GetItemRandomPropertyId()
+    //  used in BuildAuctionInfo() which then causes wrong items to be listed
+    info.nameKey = (uint64(proto->ItemId) << 32) | uint32(item->GetItemRandomPropertyId());
+
+    _classIndex[info.itemClass].insert(auction->Id);
+    _subClassIndex[(info.itemClass << 16) | info.itemSubClass].insert(auction->Id);
+    _inventoryTypeIndex[info.inventoryType].insert(auction->Id);
+    _qualityIndex[info.quality].insert(auction->Id);
+    _levelIndex[info.requiredLevel].insert(auction->Id);
+    _nameIndex[info.nameKey].auctions.insert(auction->Id);
+}
+
+static void RemoveFromIndex(std::map<uint32, std::set<uint32> >& index, uint32 key, uint32 auctionId)
+{
+    std::map<uint32, std::set<uint32> >::iterator itr = index.find(key);
+    if (itr == index.end())
+        return;
+
+    itr->second.erase(auctionId);
+    if (itr->second.empty())
+        index.erase(itr);
+}
+
+void AuctionHouseObject::RemoveFromSearchIndex(uint32 auctionId)
+{
+    AuctionSearchInfoMap::iterator itr = _searchInfo.find(auctionId);
+    if (itr == _searchInfo.end())
+        return;
+
+    AuctionSearchInfo const& info = itr->second;
+    RemoveFromIndex(_classIndex, info.itemClass, auctionId);
+    RemoveFromIndex(_subClassIndex, (info.itemClass << 16) | info.itemSubClass, auctionId);
+    RemoveFromIndex(_inventoryTypeIndex, info.inventoryType, auctionId);
+    RemoveFromIndex(_qualityIndex, info.quality, auctionId);
+    RemoveFromIndex(_levelIndex, info.requiredLevel, auctionId);
+
+    AuctionNameIndex::iterator nameItr = _nameIndex.find(info.nameKey);
+    if (nameItr != _nameIndex.end())
+    {
+        nameItr->second.auctions.erase(auctionId);
+        if (nameItr->second.auctions.empty())
+            _nameIndex.erase(nameItr);
+    }
+
+    _searchInfo.erase(itr);
+}
+
+std::wstring const& AuctionHouseObject::GetSearchName(uint64 nameKey, AuctionName& name, LocaleConstant locale)
+{
+    if (name.builtLocales & (1 << locale))
+        return name.names[locale];
+
+    name.builtLocales |= 1 << locale;
+
+    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(uint32(nameKey >> 32));
+    if (!proto || proto->Name1.empty())
+        return name.names[locale];
+
+    std::string itemName = proto->Name1;
+
+    // local name
+    if (ItemLocale const* il = sObjectMgr->GetItemLocale(proto->ItemId))
+        ObjectMgr::GetLocaleString(il->Name, locale, itemName);
+
+    // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
+    // These are found in ItemRandomProperties.dbc, not ItemRandomSuffix.dbc
+    //  even though the DBC names seem misleading
+    if (int32 propRefID = int32(uint32(nameKey)))
+    {
+        if (ItemRandomPropertiesEntry const* itemRandProp = sItemRandomPropertiesStore.LookupEntry(propRefID))
+        {
+            if (itemRandProp->nameSuffix && *itemRandProp->nameSuffix)
+            {
+                itemName += ' ';
+                itemName += itemRandProp->nameSuffix;
+            }
+        }
+    }
+
+    if (Utf8toWStr(itemName, name.names[locale]))
+        wstrToLower(name.names[locale]);
+    else
+        name.names[locale].clear();
+
+    return name.names[locale];
+}
+
+size_t AuctionHouseObject::AddCandidates(AuctionIndex const& index, uint32 minKey, uint32 maxKey, AuctionIdSetList& candidates)
+{
+    size_t count = 0;
+    for (AuctionIndex::const_iterator itr = index.lower_bound(minKey); itr != index.end() && itr->first <= maxKey; ++itr)
+    {
+        candidates.push_back(&itr->second);
+        count += itr->second.size();
+    }
+
+    return count;
+}
+
+void AuctionHouseObject::SelectCandidates(AuctionIdSetList& filterCandidates, size_t filterCount, AuctionIdSetList& candidates, size_t& candidateCount, bool& indexed)
+{
+    if (indexed && filterCount >= candidateCount)
+        return;
+
+    candidates.swap(filterCandidates);
+    candidateCount = filterCount;
+    indexed = true;
+}
+
 void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
     std::wstring const& wsearchedname, uint32 listfrom, uint8 levelmin, uint8 levelmax, uint8 usable,
     uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
     uint32& count, uint32& totalcount)
 {
-    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
-    int locdbc_idx = player->GetSession()->GetSessionDbcLocale();
+    LocaleConstant locale = player->GetSession()->GetSessionDbLocaleIndex();
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    // only the auctions of the most selective filter are looked at, the other filters are checked on them
+    AuctionIdSetList candidates;
+    size_t candidateCount = AuctionsMap.size();
+    bool indexed = false;
+
+    if (itemClass != 0xffffffff)
     {
-        AuctionEntry* Aentry = itr->second;
-        Item* item = sAuctionMgr->GetAItem(Aentry->itemGUIDLow);
-        if (!item)
-            continue;
+        AuctionIdSetList filterCandidates;
+        size_t filterCount;
+        if (itemSubClass != 0xffffffff)
+            filterCount = AddCandidates(_subClassIndex, (itemClass << 16) | itemSubClass, (itemClass << 16) | itemSubClass, filterCandidates);
+        else
+            filterCount = AddCandidates(_classIndex, itemClass, itemClass, filterCandidates);
+        SelectCandidates(filterCandidates, filterCount, candidates, candidateCount, indexed);
+    }
+
+    if (inventoryType != 0xffffffff)
+    {
+        AuctionIdSetList filterCandidates;
+        size_t filterCount = AddCandidates(_inventoryTypeIndex, inventoryType, inventoryType, filterCandidates);
+        SelectCandidates(filterCandidates, filterCount, candidates, candidateCount, indexed);
+    }
 
-        ItemTemplate const* proto = item->GetTemplate();
+    if (quality != 0xffffffff)
+    {
+        AuctionIdSetList filterCandidates;
+        size_t filterCount = AddCandidates(_qualityIndex, quality, quality, filterCandidates);
+        SelectCandidates(filterCandidates, filterCount, candidates, candidateCount, indexed);
+    }
+
+    if (levelmin != 0x00)
+    {
+        AuctionIdSetList filterCandidates;
+        size_t filterCount = AddCandidates(_levelIndex, levelmin, levelmax != 0x00 ? levelmax : 0xffffffff, filterCandidates);
+        SelectCandidates(filterCandidates, filterCount, candidates, candidateCount, indexed);
+    }
+
+    // matching the names costs one lookup per distinct item, skip it when a filter already selected fewer auctions
+    if (!wsearchedname.empty() && (!indexed || candidateCount > _nameIndex.size()))
+    {
+        AuctionIdSetList filterCandidates;
+        size_t filterCount = 0;
+        for (AuctionNameIndex::iterator itr = _nameIndex.begin(); itr != _nameIndex.end(); ++itr)
+        {
+            if (GetSearchName(itr->first, itr->second, locale).find(wsearchedname) == std::wstring::npos)
+                continue;
+
+            filterCandidates.push_back(&itr->second.auctions);
+            filterCount += itr->second.auctions.size();
+        }
+        SelectCandidates(filterCandidates, filterCount, candidates, candidateCount, indexed);
+    }
+
+    // every auction is in one set per index, so the sets never overlap
+    std::vector<uint32> auctionIds;
+    auctionIds.reserve(candidateCount);
+    if (indexed)
+    {
+        for (AuctionIdSetList::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+            auctionIds.insert(auctionIds.end(), (*itr)->begin(), (*itr)->end());
+
+        if (candidates.size() > 1)
+            std::sort(auctionIds.begin(), auctionIds.end());
+    }
+    else
+        for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+            auctionIds.push_back(itr->first);
 
-        if (itemClass != 0xffffffff && proto->Class != itemClass)
+    for (std::vector<uint32>::const_iterator idItr = auctionIds.begin(); idItr != auctionIds.end(); ++idItr)
+    {
+        AuctionSearchInfoMap::const_iterator itr = _searchInfo.find(*idItr);
+        if (itr == _searchInfo.end())
             continue;
 
-        if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+        AuctionSearchInfo const& info = itr->second;
+
+        if (itemClass != 0xffffffff && info.itemClass != itemClass)
             continue;
 
-        if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
+        if (itemSubClass != 0xffffffff && info.itemSubClass != itemSubClass)
             continue;
 
-        if (quality != 0xffffffff && proto->Quality != quality)
+        if (inventoryType != 0xffffffff && info.inventoryType != inventoryType)
             continue;
 
-        if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+        if (quality != 0xffffffff && info.quality != quality)
             continue;
 
-        if (usable != 0x00 && player->CanUseItem(item) != EQUIP_ERR_OK)
+        if (levelmin != 0x00 && (info.requiredLevel < levelmin || (levelmax != 0x00 && info.requiredLevel > levelmax)))
             continue;
 
-        // Allow search by suffix (ie: of the Monkey) or partial name (ie: Monkey)
-        // No need to do any of this if no search term was entered
-        if (!wsearchedname.empty())
+        if (usable != 0x00)
         {
-            std::string name = proto->Name1;
-            if (name.empty())
+            Item* item = sAuctionMgr->GetAItem(info.auction->itemGUIDLow);
+            if (!item || player->CanUseItem(item) != EQUIP_ERR_OK)
                 continue;
+        }
 
-            // local name
-            if (loc_idx >= 0)
-                if (ItemLocale const* il = sObjectMgr->GetItemLocale(proto->ItemId))
-                    ObjectMgr::GetLocaleString(il->Name, loc_idx, name);
-
-            // DO NOT use GetItemEnchantMod(proto->RandomProperty) as it may return a result
-            //  that matches the search but it may not equal item->GetItemRandomPropertyId()
-            //  used in BuildAuctionInfo() which then causes wrong items to be listed
-            int32 propRefID = item->GetItemRandomPropertyId();
-
-            if (propRefID)
-            {
-                // Append the suffix to the name (ie: of the Monkey) if one exists
-                // These are found in ItemRandomProperties.dbc, not ItemRandomSuffix.dbc
-                //  even though the DBC names seem misleading
-                const ItemRandomPropertiesEntry* itemRandProp = sItemRandomPropertiesStore.LookupEntry(propRefID);
-
-                if (itemRandProp)
-                {
-                    char* temp = itemRandProp->nameSuffix;
-
-                    // dbc local name
-                    if (temp)
-                    {
-                        // Append the suffix (ie: of the Monkey) to the name using localization
-                        // or default enUS if localization is invalid
-                        name += ' ';
-                        name += temp[locdbc_idx >= 0 ? locdbc_idx : LOCALE_enUS];
-                    }
-                }
-            }
-
-            // Perform the search (with or without suffix)
-            if (!Utf8FitTo(name, wsearchedname))
+        // No need to do any of this if no search term was entered
+        if (!wsearchedname.empty())
+        {
+            AuctionNameIndex::iterator nameItr = _nameIndex.find(info.nameKey);
+            if (nameItr == _nameIndex.end() || GetSearchName(nameItr->first, nameItr->second, locale).find(wsearchedname) == std::wstring::npos)
                 continue;
         }
 
@@ -596,7 +760,7 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
         if (count < 50 && totalcount >= listfrom)
         {
             ++count;
-            Aentry->BuildAuctionInfo(data);
+            info.auction->BuildAuctionInfo(data);
         }
         ++totalcount;
     }
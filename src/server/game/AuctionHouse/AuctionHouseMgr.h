@@ -32,6 +32,10 @@ class WorldPacket;
 #define MIN_AUCTION_TIME (12*HOUR)
 #define MAX_AUCTION_ITEMS 160
 
+// expired auctions handled in one transaction, and by one house in one update
+#define AUCTION_EXPIRE_BATCH_SIZE 50
+#define AUCTION_EXPIRE_PER_UPDATE 500
+
 enum AuctionError
 {
     ERR_AUCTION_OK                  = 0,
@@ -124,7 +128,8 @@ class AuctionHouseObject
 
     bool RemoveAuction(AuctionEntry* auction, uint32 itemEntry);
 
-    void Update();
+    // returns true when expired auctions were left for the next update
+    bool Update();
 
     void BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
     void BuildListOwnerItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
@@ -134,8 +139,58 @@ class AuctionHouseObject
         uint32& count, uint32& totalcount);
 
   private:
+    typedef std::set<uint32> AuctionIdSet;                   // sorted like AuctionsMap, keeps the list order stable
+    typedef std::map<uint32, AuctionIdSet> AuctionIndex;
+    typedef std::vector<AuctionIdSet const*> AuctionIdSetList;
+
+    // item properties looked at by the browse filters, copied when the auction is added
+    struct AuctionSearchInfo
+    {
+        AuctionEntry* auction;
+        uint32 itemClass;
+        uint32 itemSubClass;
+        uint32 inventoryType;
+        uint32 quality;
+        uint32 requiredLevel;
+        uint64 nameKey;                                     // item entry and random property, see AuctionNameIndex
+    };
+
+    typedef UNORDERED_MAP<uint32, AuctionSearchInfo> AuctionSearchInfoMap;
+
+    // auctions of the same item with the same suffix share their name,
+    // lower-cased names are built once per locale on the first search using them
+    struct AuctionName
+    {
+        AuctionName() : builtLocales(0) { }
+
+        AuctionIdSet auctions;
+        std::wstring names[TOTAL_LOCALES];
+        uint32 builtLocales;
+    };
+
+    typedef std::map<uint64, AuctionName> AuctionNameIndex;
+
+    void AddToSearchIndex(AuctionEntry* auction);
+    void RemoveFromSearchIndex(uint32 auctionId);
+    std::wstring const& GetSearchName(uint64 nameKey, AuctionName& name, LocaleConstant locale);
+    static size_t AddCandidates(AuctionIndex const& index, uint32 minKey, uint32 maxKey, AuctionIdSetList& candidates);
+    static void SelectCandidates(AuctionIdSetList& filterCandidates, size_t filterCount, AuctionIdSetList& candidates, size_t& candidateCount, bool& indexed);
+
     AuctionEntryMap AuctionsMap;
 
+    // secondary indexes of the browse filters
+    AuctionSearchInfoMap _searchInfo;
+    AuctionIndex _classIndex;
+    AuctionIndex _subClassIndex;                            // (class << 16) | subclass
+    AuctionIndex _inventoryTypeIndex;
+    AuctionIndex _qualityIndex;
+    AuctionIndex _levelIndex;
+    AuctionNameIndex _nameIndex;
+
+    // auctions by expire time, so Update() never has to look at the database
+    typedef std::set<std::pair<time_t, uint32> > AuctionExpiryIndex;
+    AuctionExpiryIndex _expiryIndex;
+
     // storage for "next" auction item for next Update()
     AuctionEntryMap::const_iterator next;
 };
@@ -188,6 +243,8 @@ class AuctionHouseMgr
         bool RemoveAItem(uint32 id);
 
         void Update();
+        // a mass expiry is spread over the next world updates
+        bool HasExpiryBacklog() const { return _expiryBacklog; }
 
     private:
 
@@ -196,6 +253,7 @@ class AuctionHouseMgr
         AuctionHouseObject mNeutralAuctions;
 
         ItemMap mAitems;
+        bool _expiryBacklog;
 };
 
 #define sAuctionMgr ACE_Singleton<AuctionHouseMgr, ACE_Null_Mutex>::instance()
@@ -130,7 +130,7 @@ bool BattlefieldTB::SetupBattlefield()
 
     // Hide keep npc
     for(GuidSet::const_iterator itr = KeepCreature[GetAttackerTeam()].begin(); itr != KeepCreature[GetAttackerTeam()].end(); ++itr)
-        if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
@@ -147,12 +147,12 @@ bool BattlefieldTB::SetupBattlefield()
 
     // Hide battle npcs
     for(GuidSet::const_iterator itr = WarCreature[GetDefenderTeam()].begin(); itr != WarCreature[GetDefenderTeam()].end(); ++itr)
-        if (Unit* unit = sObjectAccessor->FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
     for(GuidSet::const_iterator itr = WarCreature[GetAttackerTeam()].begin(); itr != WarCreature[GetAttackerTeam()].end(); ++itr)
-        if (Unit* unit = sObjectAccessor->FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
@@ -244,24 +244,24 @@ void BattlefieldTB::OnBattleStart()
 
     //Hide keep npc
     for(GuidSet::const_iterator itr = KeepCreature[GetAttackerTeam()].begin(); itr != KeepCreature[GetAttackerTeam()].end(); ++itr)
-        if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
     for(GuidSet::const_iterator itr = KeepCreature[GetDefenderTeam()].begin(); itr != KeepCreature[GetDefenderTeam()].end(); ++itr)
-        if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
     //Show battle npcs
     for(GuidSet::const_iterator itr = WarCreature[GetDefenderTeam()].begin(); itr != WarCreature[GetDefenderTeam()].end(); ++itr)
-        if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
     //Show battle npcs
     for(GuidSet::const_iterator itr = WarCreature[GetAttackerTeam()].begin(); itr != WarCreature[GetAttackerTeam()].end(); ++itr)
-        if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+        if (Unit* unit = GetCreature(*itr))
             if (Creature* creature = unit->ToCreature())
                 HideNpc(creature);
 
@@ -276,39 +276,39 @@ void BattlefieldTB::OnBattleEnd(bool endbytimer)
         //Change all npc in keep
         for(GuidSet::const_iterator itr = KeepCreature[GetAttackerTeam()].begin(); itr != KeepCreature[GetAttackerTeam()].end(); ++itr)
         {
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     HideNpc(creature);
         }
         for(GuidSet::const_iterator itr = KeepCreature[GetDefenderTeam()].begin(); itr != KeepCreature[GetDefenderTeam()].end(); ++itr)
         {
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     ShowNpc(creature,true);
         }
         // Hide creatures that should be visible only when battle is on.
         for(GuidSet::const_iterator itr = WarCreature[GetAttackerTeam()].begin(); itr != WarCreature[GetAttackerTeam()].end(); ++itr)
         {
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     HideNpc(creature);
         }
         for(GuidSet::const_iterator itr = WarCreature[GetDefenderTeam()].begin(); itr != WarCreature[GetDefenderTeam()].end(); ++itr)
         {
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     HideNpc(creature);
         }
         /*//Change all npc out of keep
         for(GuidSet::const_iterator itr = OutsideCreature[GetDefenderTeam()].begin(); itr != OutsideCreature[GetDefenderTeam()].end(); ++itr)
         {
-            if (Unit* unit = sObjectAccessor->FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     HideNpc(creature);
         }
         for(GuidSet::const_iterator itr = OutsideCreature[GetAttackerTeam()].begin(); itr != OutsideCreature[GetAttackerTeam()].end(); ++itr)
         {
-            if (Unit* unit = sObjectAccessor->FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     ShowNpc(creature,true);
         }*/
@@ -384,7 +384,7 @@ void BattlefieldTB::OnBattleEnd(bool endbytimer)
 
         for(GuidSet::const_iterator itr = m_vehicles[team].begin(); itr != m_vehicles[team].end(); ++itr)
         {
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     if (creature->IsVehicle())
                         creature->GetVehicleKit()->Dismiss();
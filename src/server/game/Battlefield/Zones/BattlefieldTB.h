@@ -588,22 +588,22 @@ struct BfTBGameObjectBuilding
     void UpdateCreatureAndGo()
     {
         for(GuidSet::const_iterator itr = m_CreatureTopList[m_TB->GetDefenderTeam()].begin(); itr != m_CreatureTopList[m_TB->GetDefenderTeam()].end(); ++itr)
-              if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+              if (Unit* unit = m_TB->GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     m_TB->HideNpc(creature);
 
         for(GuidSet::const_iterator itr = m_CreatureTopList[m_TB->GetAttackerTeam()].begin(); itr != m_CreatureTopList[m_TB->GetAttackerTeam()].end(); ++itr)
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = m_TB->GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     m_TB->ShowNpc(creature, true);
 
         for(GuidSet::const_iterator itr = m_CreatureBottomList[m_TB->GetDefenderTeam()].begin(); itr != m_CreatureBottomList[m_TB->GetDefenderTeam()].end(); ++itr)
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = m_TB->GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     m_TB->HideNpc(creature);
 
         for(GuidSet::const_iterator itr = m_CreatureBottomList[m_TB->GetAttackerTeam()].begin(); itr != m_CreatureBottomList[m_TB->GetAttackerTeam()].end(); ++itr)
-            if (Unit* unit = ObjectAccessor::FindUnit((*itr)))
+            if (Unit* unit = m_TB->GetCreature(*itr))
                 if (Creature* creature = unit->ToCreature())
                     m_TB->ShowNpc(creature, true);
 
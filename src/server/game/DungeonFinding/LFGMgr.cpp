@@ -31,9 +31,31 @@
 #include "Group.h"
 #include "Player.h"
 
+LfgCompatibilityKey::LfgCompatibilityKey(LfgGuidList const& check)
+{
+    uint8 count = 0;
+    for (LfgGuidList::const_iterator it = check.begin(); it != check.end() && count < LFG_MAX_CHECKED_GUIDS; ++it)
+        guids[count++] = *it;
+
+    while (count < LFG_MAX_CHECKED_GUIDS)
+        guids[count++] = 0;
+
+    std::sort(guids, guids + LFG_MAX_CHECKED_GUIDS);
+}
+
+bool LfgCompatibilityKey::operator<(LfgCompatibilityKey const& right) const
+{
+    return std::lexicographical_compare(guids, guids + LFG_MAX_CHECKED_GUIDS, right.guids, right.guids + LFG_MAX_CHECKED_GUIDS);
+}
+
+bool LfgCompatibilityKey::Contains(uint64 guid) const
+{
+    return std::find(guids, guids + LFG_MAX_CHECKED_GUIDS, guid) != guids + LFG_MAX_CHECKED_GUIDS;
+}
+
 LFGMgr::LFGMgr(): m_update(true), m_QueueTimer(0), m_lfgProposalId(1),
 m_WaitTimeAvg(-1), m_WaitTimeTank(-1), m_WaitTimeHealer(-1), m_WaitTimeDps(-1),
-m_NumWaitTimeAvg(0), m_NumWaitTimeTank(0), m_NumWaitTimeHealer(0), m_NumWaitTimeDps(0)
+m_NumWaitTimeAvg(0), m_NumWaitTimeTank(0), m_NumWaitTimeHealer(0), m_NumWaitTimeDps(0), m_CompatibleStamp(0)
 {
     m_update = sWorld->getIntConfig(CONFIG_DUNGEON_FINDER_ENABLE);
     if (m_update)
@@ -257,6 +279,7 @@ void LFGMgr::Update(uint32 diff)
             firstNew.push_back(frontguid);
             newToQueue.pop_front();
 
+            // copied as stale entries may be removed from the queue while checking
             LfgGuidList temporalList = currentQueue;
             if (LfgProposal* pProposal = FindNewGroups(firstNew, temporalList)) // Group found!
             {
@@ -666,6 +689,7 @@ void LFGMgr::Join(Player* player, uint8 roles, const LfgDungeonSet& selectedDung
         pqInfo->joinTime = time_t(time(NULL));
         pqInfo->roles[player->GetGUID()] = roles;
         pqInfo->dungeons = dungeons;
+        SetQueueInfoMasks(pqInfo);
         int32 waitTime = 0;
         if (roles & ROLE_TANK)
         {
@@ -796,22 +820,43 @@ void LFGMgr::OfferContinue(Group* grp)
    @param[in]     all List of all other guids in main queue to match against
    @return Pointer to proposal, if match is found
 */
-LfgProposal* LFGMgr::FindNewGroups(LfgGuidList& check, LfgGuidList& all)
+LfgProposal* LFGMgr::FindNewGroups(LfgGuidList& check, const LfgGuidList& all)
 {
-    sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::FindNewGroup: (%s) - all(%s)", ConcatenateGuids(check).c_str(), ConcatenateGuids(all).c_str());
+    if (sLog->ShouldLog(LOG_FILTER_LFG, LOG_LEVEL_DEBUG))
+        sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::FindNewGroup: (%s) - all(%s)", ConcatenateGuids(check).c_str(), ConcatenateGuids(all).c_str());
 
     LfgProposal* pProposal = NULL;
     if (check.empty() || check.size() > MAXGROUPSIZE || !CheckCompatibility(check, pProposal))
         return NULL;
 
-    // Try to match with queued groups
-    while (!pProposal && !all.empty())
+    // Try to match with queued groups, depth first over the combinations in queue order. Only
+    // compatible combinations are extended, a dead end backtracks to try the next queued group
+    // in place of the last one taken. Answers for the combinations are cached by CheckCompatibility.
+    size_t checkSize = check.size();
+    std::vector<LfgGuidList::const_iterator> resume;        // where to continue once the matching taken group is dropped
+    LfgGuidList::const_iterator it = all.begin();
+    while (!pProposal)
     {
-        check.push_back(all.front());
-        all.pop_front();
-        pProposal = FindNewGroups(check, all);
+        if (it != all.end() && check.size() < MAXGROUPSIZE)
+        {
+            check.push_back(*it++);
+            if (CheckCompatibility(check, pProposal))
+                resume.push_back(it);
+            else
+                check.pop_back();
+            continue;
+        }
+
+        if (resume.empty())
+            break;
+
         check.pop_back();
+        it = resume.back();
+        resume.pop_back();
     }
+
+    // the proposal keeps its own copy of the guids
+    check.resize(checkSize);
     return pProposal;
 }
 
@@ -822,12 +867,15 @@ LfgProposal* LFGMgr::FindNewGroups(LfgGuidList& check, LfgGuidList& all)
    @param[out]    pProposal Proposal found if groups are compatibles and Match
    @return true if group are compatibles
 */
-bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
+bool LFGMgr::CheckCompatibility(LfgGuidList& check, LfgProposal*& pProposal)
 {
     if (pProposal)                                         // Do not check anything if we already have a proposal
         return false;
 
-    std::string strGuids = ConcatenateGuids(check);
+    // only built for the debug output
+    std::string strGuids;
+    if (sLog->ShouldLog(LOG_FILTER_LFG, LOG_LEVEL_DEBUG))
+        strGuids = ConcatenateGuids(check);
 
     if (check.size() > MAXGROUPSIZE || check.empty())
     {
@@ -839,7 +887,8 @@ bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
         return true;
 
     // Previously cached?
-    LfgAnswer answer = GetCompatibles(strGuids);
+    LfgCompatibilityKey key(check);
+    LfgAnswer answer = GetCompatibles(key);
     if (answer != LFG_ANSWER_PENDING)
     {
         sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::CheckCompatibility: (%s) compatibles (cached): %d", strGuids.c_str(), answer);
@@ -853,13 +902,15 @@ bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
         check.pop_front();
 
         // Check all-but-new compatibilities (New, A, B, C, D) --> check(A, B, C, D)
-        if (!CheckCompatibility(check, pProposal))          // Group not compatible
+        bool compatibles = CheckCompatibility(check, pProposal);
+        check.push_front(frontGuid);
+
+        if (!compatibles)                                   // Group not compatible
         {
-            sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::CheckCompatibility: (%s) not compatibles (%s not compatibles)", strGuids.c_str(), ConcatenateGuids(check).c_str());
-            SetCompatibles(strGuids, false);
+            sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::CheckCompatibility: (%s) not compatibles (all but the first not compatibles)", strGuids.c_str());
+            SetCompatibles(key, false);
             return false;
         }
-        check.push_front(frontGuid);
         // all-but-new compatibles, now check with new
     }
 
@@ -899,7 +950,7 @@ bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
     // Do not match - groups already in a lfgDungeon or too much players
     if (numLfgGroups > 1 || numPlayers > MAXGROUPSIZE)
     {
-        SetCompatibles(strGuids, false);
+        SetCompatibles(key, false);
         if (numLfgGroups > 1)
             sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::CheckCompatibility: (%s) More than one Lfggroup (%u)", strGuids.c_str(), numLfgGroups);
         else
@@ -907,6 +958,24 @@ bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
         return false;
     }
 
+    // ----- Quick checks with the masks computed when queued -----
+    uint64 dungeonMask = ~uint64(0);
+    uint8 onlyTanks = 0, onlyHealers = 0, onlyDps = 0;
+    for (LfgQueueInfoMap::const_iterator it = pqInfoMap.begin(); it != pqInfoMap.end(); ++it)
+    {
+        dungeonMask &= it->second->dungeonMask;
+        onlyTanks += it->second->onlyTanks;
+        onlyHealers += it->second->onlyHealers;
+        onlyDps += it->second->onlyDps;
+    }
+
+    if (!dungeonMask || onlyTanks > LFG_TANKS_NEEDED || onlyHealers > LFG_HEALERS_NEEDED || onlyDps > LFG_DPS_NEEDED)
+    {
+        sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::CheckCompatibility: (%s) No common dungeon or roles not compatible", strGuids.c_str());
+        SetCompatibles(key, false);
+        return false;
+    }
+
     // ----- Player checks -----
     LfgRolesMap rolesMap;
     uint64 leader = 0;
@@ -953,7 +1022,7 @@ bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
     {
         if (players.size() == numPlayers)
             sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::CheckCompatibility: (%s) Roles not compatible", strGuids.c_str());
-        SetCompatibles(strGuids, false);
+        SetCompatibles(key, false);
         return false;
     }
 
@@ -977,10 +1046,10 @@ bool LFGMgr::CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal)
 
     if (compatibleDungeons.empty())
     {
-        SetCompatibles(strGuids, false);
+        SetCompatibles(key, false);
         return false;
     }
-    SetCompatibles(strGuids, true);
+    SetCompatibles(key, true);
 
     // ----- Group is compatible, if we have MAXGROUPSIZE members then match is found
     if (numPlayers != MAXGROUPSIZE)
@@ -1163,6 +1232,7 @@ void LFGMgr::UpdateRoleCheck(uint64 gguid, uint64 guid /* = 0 */, uint8 roles /*
         pqInfo->joinTime = time_t(time(NULL));
         pqInfo->roles = roleCheck->roles;
         pqInfo->dungeons = roleCheck->dungeons;
+        SetQueueInfoMasks(pqInfo);
 
         // Set queue roles needed - As we are using check_roles will not have more that 1 tank, 1 healer, 3 dps
         for (LfgRolesMap::const_iterator it = check_roles.begin(); it != check_roles.end(); ++it)
@@ -1194,6 +1264,39 @@ void LFGMgr::UpdateRoleCheck(uint64 gguid, uint64 guid /* = 0 */, uint8 roles /*
     }
 }
 
+/**
+   Computes the masks used to reject incompatible queue entries before the full check
+
+   @param[in,out] pqInfo Queue info with roles and dungeons already set
+*/
+void LFGMgr::SetQueueInfoMasks(LfgQueueInfo* pqInfo)
+{
+    pqInfo->dungeonMask = 0;
+    for (LfgDungeonSet::const_iterator it = pqInfo->dungeons.begin(); it != pqInfo->dungeons.end(); ++it)
+        pqInfo->dungeonMask |= uint64(1) << (*it % 64);
+
+    pqInfo->onlyTanks = 0;
+    pqInfo->onlyHealers = 0;
+    pqInfo->onlyDps = 0;
+    for (LfgRolesMap::const_iterator it = pqInfo->roles.begin(); it != pqInfo->roles.end(); ++it)
+    {
+        switch (it->second & ~ROLE_LEADER)
+        {
+            case ROLE_TANK:
+                ++pqInfo->onlyTanks;
+                break;
+            case ROLE_HEALER:
+                ++pqInfo->onlyHealers;
+                break;
+            case ROLE_DAMAGE:
+                ++pqInfo->onlyDps;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
 /**
    Remove from cached compatible dungeons any entry that contains the given guid
 
@@ -1201,42 +1304,59 @@ void LFGMgr::UpdateRoleCheck(uint64 gguid, uint64 guid /* = 0 */, uint8 roles /*
 */
 void LFGMgr::RemoveFromCompatibles(uint64 guid)
 {
-    std::stringstream out;
-    out << guid;
-    std::string strGuid = out.str();
-
     sLog->outDebug(LOG_FILTER_LFG, "LFGMgr::RemoveFromCompatibles: Removing [" UI64FMTD "]", guid);
     for (LfgCompatibleMap::iterator itNext = m_CompatibleMap.begin(); itNext != m_CompatibleMap.end();)
     {
         LfgCompatibleMap::iterator it = itNext++;
-        if (it->first.find(strGuid) != std::string::npos)  // Found, remove it
+        if (it->first.Contains(guid))                      // Found, remove it
             m_CompatibleMap.erase(it);
     }
 }
 
 /**
-   Stores the compatibility of a list of guids
+   Stores the compatibility of a list of guids, dropping the oldest answers once the cache is full
 
-   @param[in]     key String concatenation of guids (| used as separator)
+   @param[in]     key Sorted guids
    @param[in]     compatibles Compatibles or not
 */
-void LFGMgr::SetCompatibles(std::string key, bool compatibles)
+void LFGMgr::SetCompatibles(const LfgCompatibilityKey& key, bool compatibles)
 {
-    m_CompatibleMap[key] = LfgAnswer(compatibles);
+    LfgCompatibleEntry entry;
+    entry.answer = LfgAnswer(compatibles);
+    entry.stamp = ++m_CompatibleStamp;
+
+    std::pair<LfgCompatibleMap::iterator, bool> result = m_CompatibleMap.insert(LfgCompatibleMap::value_type(key, entry));
+    if (!result.second)
+    {
+        result.first->second.answer = entry.answer;
+        return;
+    }
+
+    m_CompatibleQueue.push_back(std::make_pair(key, entry.stamp));
+
+    // keys removed by RemoveFromCompatibles are still queued, and may have been stored again
+    // since. Only the entry stored together with the queued one is dropped.
+    while (m_CompatibleMap.size() > LFG_COMPATIBLE_CACHE_SIZE || m_CompatibleQueue.size() > 2 * LFG_COMPATIBLE_CACHE_SIZE)
+    {
+        LfgCompatibleMap::iterator it = m_CompatibleMap.find(m_CompatibleQueue.front().first);
+        if (it != m_CompatibleMap.end() && it->second.stamp == m_CompatibleQueue.front().second)
+            m_CompatibleMap.erase(it);
+        m_CompatibleQueue.pop_front();
+    }
 }
 
 /**
    Get the compatibility of a group of guids
 
-   @param[in]     key String concatenation of guids (| used as separator)
+   @param[in]     key Sorted guids
    @return 1 (Compatibles), 0 (Not compatibles), -1 (Not set)
 */
-LfgAnswer LFGMgr::GetCompatibles(std::string key)
+LfgAnswer LFGMgr::GetCompatibles(const LfgCompatibilityKey& key)
 {
     LfgAnswer answer = LFG_ANSWER_PENDING;
     LfgCompatibleMap::iterator it = m_CompatibleMap.find(key);
     if (it != m_CompatibleMap.end())
-        answer = it->second;
+        answer = it->second.answer;
 
     return answer;
 }
@@ -2006,7 +2126,7 @@ LfgType LFGMgr::GetDungeonType(uint32 dungeonId)
    @param[in]     check list of guids
    @returns Concatenated string
 */
-std::string LFGMgr::ConcatenateGuids(LfgGuidList check)
+std::string LFGMgr::ConcatenateGuids(const LfgGuidList& check)
 {
     if (check.empty())
         return "";
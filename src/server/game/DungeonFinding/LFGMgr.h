@@ -37,6 +37,8 @@ enum LFGenum
     LFG_HEALERS_NEEDED                           = 1,
     LFG_DPS_NEEDED                               = 3,
     LFG_QUEUEUPDATE_INTERVAL                     = 15*IN_MILLISECONDS,
+    LFG_MAX_CHECKED_GUIDS                        = 5,      // groups/players checked together, one per member at most
+    LFG_COMPATIBLE_CACHE_SIZE                    = 50000,  // cached compatibility answers, oldest are dropped first
     LFG_SPELL_DUNGEON_COOLDOWN                   = 71328,
     LFG_SPELL_DUNGEON_DESERTER                   = 71041,
     LFG_SPELL_LUCK_OF_THE_DRAW                   = 72221
@@ -133,7 +135,6 @@ typedef std::set<Player*> PlayerPointerSet;
 typedef std::list<Player*> LfgPlayerList;
 typedef std::multimap<uint32, LfgReward const*> LfgRewardMap;
 typedef std::pair<LfgRewardMap::const_iterator, LfgRewardMap::const_iterator> LfgRewardMapBounds;
-typedef std::map<std::string, LfgAnswer> LfgCompatibleMap;
 typedef std::map<uint64, LfgDungeonSet> LfgDungeonMap;
 typedef std::map<uint64, uint8> LfgRolesMap;
 typedef std::map<uint64, LfgAnswer> LfgAnswerMap;
@@ -146,6 +147,27 @@ typedef std::map<uint64, LfgGroupData> LfgGroupDataMap;
 typedef std::map<uint64, LfgPlayerData> LfgPlayerDataMap;
 typedef std::map<uint32, LFGDungeonEntry const*> LfgDungeonsMap;
 
+/// Guids checked together for compatibility, sorted so the order they are checked in does not matter
+struct LfgCompatibilityKey
+{
+    explicit LfgCompatibilityKey(LfgGuidList const& check);
+
+    bool operator<(LfgCompatibilityKey const& right) const;
+    bool Contains(uint64 guid) const;
+
+    uint64 guids[LFG_MAX_CHECKED_GUIDS];                   ///< Unused slots are 0
+};
+
+/// Cached answer, stamped so a key dropped and stored again is not evicted by its old queue entry
+struct LfgCompatibleEntry
+{
+    LfgAnswer answer;
+    uint32 stamp;
+};
+
+typedef std::map<LfgCompatibilityKey, LfgCompatibleEntry> LfgCompatibleMap;
+typedef std::deque<std::pair<LfgCompatibilityKey, uint32> > LfgCompatibleQueue;
+
 // Data needed by SMSG_LFG_JOIN_RESULT
 struct LfgJoinResultData
 {
@@ -194,13 +216,19 @@ struct LfgReward
 /// Stores player or group queue info
 struct LfgQueueInfo
 {
-    LfgQueueInfo(): joinTime(0), tanks(LFG_TANKS_NEEDED), healers(LFG_HEALERS_NEEDED), dps(LFG_DPS_NEEDED) {};
+    LfgQueueInfo(): joinTime(0), tanks(LFG_TANKS_NEEDED), healers(LFG_HEALERS_NEEDED), dps(LFG_DPS_NEEDED),
+        dungeonMask(0), onlyTanks(0), onlyHealers(0), onlyDps(0) {};
     time_t joinTime;                                       ///< Player queue join time (to calculate wait times)
     uint8 tanks;                                           ///< Tanks needed
     uint8 healers;                                         ///< Healers needed
     uint8 dps;                                             ///< Dps needed
     LfgDungeonSet dungeons;                                ///< Selected Player/Group Dungeon/s
     LfgRolesMap roles;                                     ///< Selected Player Role/s
+    // Computed when queued, to reject incompatible groups before the full check
+    uint64 dungeonMask;                                    ///< Bit (dungeon % 64) of every selected dungeon
+    uint8 onlyTanks;                                       ///< Players that can only be tank
+    uint8 onlyHealers;                                     ///< Players that can only be healer
+    uint8 onlyDps;                                         ///< Players that can only be dps
 };
 
 /// Stores player data related to proposal to join
@@ -326,18 +354,19 @@ class LFGMgr
         void RemoveProposal(LfgProposalMap::iterator itProposal, LfgUpdateType type);
 
         // Group Matching
-        LfgProposal* FindNewGroups(LfgGuidList& check, LfgGuidList& all);
+        LfgProposal* FindNewGroups(LfgGuidList& check, const LfgGuidList& all);
         bool CheckGroupRoles(LfgRolesMap &groles, bool removeLeaderFlag = true);
-        bool CheckCompatibility(LfgGuidList check, LfgProposal*& pProposal);
+        bool CheckCompatibility(LfgGuidList& check, LfgProposal*& pProposal);
         void GetCompatibleDungeons(LfgDungeonSet& dungeons, const PlayerPointerSet& players, LfgLockPartyMap& lockMap);
-        void SetCompatibles(std::string concatenatedGuids, bool compatibles);
-        LfgAnswer GetCompatibles(std::string concatenatedGuids);
+        void SetCompatibles(const LfgCompatibilityKey& key, bool compatibles);
+        LfgAnswer GetCompatibles(const LfgCompatibilityKey& key);
         void RemoveFromCompatibles(uint64 guid);
+        void SetQueueInfoMasks(LfgQueueInfo* pqInfo);
 
         // Generic
         const LfgDungeonSet& GetDungeonsByRandom(uint32 randomdungeon);
         LfgType GetDungeonType(uint32 dungeon);
-        std::string ConcatenateGuids(LfgGuidList check);
+        std::string ConcatenateGuids(const LfgGuidList& check);
 
         // General variables
         bool m_update;                                     ///< Doing an update?
@@ -359,6 +388,8 @@ class LFGMgr
         LfgGuidListMap m_currentQueue;                     ///< Ordered list. Used to find groups
         LfgGuidListMap m_newToQueue;                       ///< New groups to add to queue
         LfgCompatibleMap m_CompatibleMap;                  ///< Compatible dungeons
+        LfgCompatibleQueue m_CompatibleQueue;              ///< Keys and stamps of m_CompatibleMap by insertion time
+        uint32 m_CompatibleStamp;                          ///< Stamp of the last answer stored
         LfgGuidList m_teleport;                            ///< Players being teleported
         // Rolecheck - Proposal - Vote Kicks
         LfgRoleCheckMap m_RoleChecks;                      ///< Current Role checks
@@ -58,7 +58,10 @@ void Corpse::RemoveFromWorld()
 {
     ///- Remove the corpse from the accessor
     if (IsInWorld())
+    {
         sObjectAccessor->RemoveObject(this);
+        ClearObservers();
+    }
 
     Object::RemoveFromWorld();
 }
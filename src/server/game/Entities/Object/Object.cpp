@@ -78,7 +78,6 @@ Object::Object() : m_PackGUID(sizeof(uint64)+1)
     m_objectType        = TYPEMASK_OBJECT;
 
     m_uint32Values      = NULL;
-    _changedFields      = NULL;
     m_valuesCount       = 0;
     _fieldNotifyFlags   = UF_FLAG_DYNAMIC;
 
@@ -122,7 +121,6 @@ Object::~Object()
     }
 
     delete [] m_uint32Values;
-    delete [] _changedFields;
 
 }
 
@@ -131,8 +129,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[m_valuesCount];
     memset(m_uint32Values, 0, m_valuesCount*sizeof(uint32));
 
-    _changedFields = new bool[m_valuesCount];
-    memset(_changedFields, 0, m_valuesCount*sizeof(bool));
+    _changedFields.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -272,8 +269,21 @@ void Object::SendUpdateToPlayer(Player* player)
     player->GetSession()->SendPacket(&packet);
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, UpdateBlockCache* cache) const
 {
+    uint8 visibilityClass = GetUpdateFieldVisibilityClass(target);
+
+    // receivers of the same class get the same block unless it has fields written per receiver
+    if (cache)
+    {
+        UpdateBlockCache::const_iterator itr = cache->find(visibilityClass);
+        if (itr != cache->end())
+        {
+            data->AddUpdateBlock(itr->second);
+            return;
+        }
+    }
+
     ByteBuffer buf(500);
 
     buf << uint8(UPDATETYPE_VALUES);
@@ -286,9 +296,12 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
 
     updateMask.SetCount(valCount);
 
-    _SetUpdateBits(&updateMask, target);
+    _SetUpdateBits(&updateMask, visibilityClass);
     _BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
 
+    if (cache && !HasTargetDependentValues(updateMask))
+        (*cache)[visibilityClass] = buf;
+
     data->AddUpdateBlock(buf);
 }
 
@@ -949,17 +962,36 @@ void Object::_BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask*
 
 void Object::ClearUpdateMask(bool remove)
 {
-    memset(_changedFields, 0, m_valuesCount*sizeof(bool));
+    _changedFields.Clear();
 
     if (m_objectUpdated)
     {
         if (remove)
-            sObjectAccessor->RemoveUpdateObject(this);
+            RemoveFromObjectUpdate();
         m_objectUpdated = false;
     }
 }
 
-void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
+void Object::AddToObjectUpdateIfNeeded()
+{
+    if (m_inWorld && !m_objectUpdated)
+    {
+        AddToObjectUpdate();
+        m_objectUpdated = true;
+    }
+}
+
+void Object::AddToObjectUpdate()
+{
+    sObjectAccessor->AddUpdateObject(this);
+}
+
+void Object::RemoveFromObjectUpdate()
+{
+    sObjectAccessor->RemoveUpdateObject(this);
+}
+
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, UpdateBlockCache* cache) const
 {
     UpdateDataMapType::iterator iter = data_map.find(player);
 
@@ -970,7 +1002,7 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache);
 }
 
 void Object::GetUpdateFieldData(Player const* target, uint32*& flags, bool& isOwner, bool& isItemOwner, bool& hasSpecialInfo, bool& isPartyMember) const
@@ -1013,6 +1045,93 @@ void Object::GetUpdateFieldData(Player const* target, uint32*& flags, bool& isOw
     }
 }
 
+static UpdateFieldMasks const& GetUpdateFieldMasks(TypeID typeId)
+{
+    switch (typeId)
+    {
+        case TYPEID_ITEM:
+        case TYPEID_CONTAINER:
+        {
+            static UpdateFieldMasks const masks(ItemUpdateFieldFlags, CONTAINER_END);
+            return masks;
+        }
+        case TYPEID_UNIT:
+        case TYPEID_PLAYER:
+        {
+            static UpdateFieldMasks const masks(UnitUpdateFieldFlags, PLAYER_END);
+            return masks;
+        }
+        case TYPEID_GAMEOBJECT:
+        {
+            static UpdateFieldMasks const masks(GameObjectUpdateFieldFlags, GAMEOBJECT_END);
+            return masks;
+        }
+        case TYPEID_DYNAMICOBJECT:
+        {
+            static UpdateFieldMasks const masks(DynamicObjectUpdateFieldFlags, DYNAMICOBJECT_END);
+            return masks;
+        }
+        case TYPEID_CORPSE:
+        {
+            static UpdateFieldMasks const masks(CorpseUpdateFieldFlags, CORPSE_END);
+            return masks;
+        }
+        case TYPEID_AREATRIGGER:
+        {
+            static UpdateFieldMasks const masks(AreaTriggerUpdateFieldFlags, AREATRIGGER_END);
+            return masks;
+        }
+        default:
+        {
+            static UpdateFieldMasks const masks(NULL, 0);
+            return masks;
+        }
+    }
+}
+
+uint8 Object::GetUpdateFieldVisibilityClass(Player const* target) const
+{
+    uint32* flags = NULL;
+    bool isOwner = false;
+    bool isItemOwner = false;
+    bool hasSpecialInfo = false;
+    bool isPartyMember = false;
+
+    GetUpdateFieldData(target, flags, isOwner, isItemOwner, hasSpecialInfo, isPartyMember);
+
+    uint8 visibilityClass = 0;
+    if (target == this)
+        visibilityClass |= UF_VISIBILITY_SELF;
+    if (isOwner)
+        visibilityClass |= UF_VISIBILITY_OWNER;
+    if (isItemOwner)
+        visibilityClass |= UF_VISIBILITY_ITEM_OWNER;
+    if (isPartyMember)
+        visibilityClass |= UF_VISIBILITY_PARTY_MEMBER;
+    if (hasSpecialInfo)
+        visibilityClass |= UF_VISIBILITY_SPECIAL_INFO;
+
+    return visibilityClass;
+}
+
+// fields _BuildValuesUpdate writes differently for each receiver
+bool Object::HasTargetDependentValues(UpdateMask const& updateMask) const
+{
+    if (isType(TYPEMASK_UNIT))
+        return updateMask.GetBit(UNIT_NPC_FLAGS) || updateMask.GetBit(UNIT_FIELD_AURASTATE) ||
+            updateMask.GetBit(UNIT_FIELD_FLAGS) || updateMask.GetBit(UNIT_FIELD_DISPLAYID) ||
+            updateMask.GetBit(UNIT_DYNAMIC_FLAGS) || updateMask.GetBit(UNIT_FIELD_BYTES_2) ||
+            updateMask.GetBit(UNIT_FIELD_FACTIONTEMPLATE);
+
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return updateMask.GetBit(GAMEOBJECT_DYNAMIC) || updateMask.GetBit(GAMEOBJECT_FLAGS);
+
+    if (isType(TYPEMASK_DYNAMICOBJECT))
+        return updateMask.GetBit(DYNAMICOBJECT_BYTES);
+
+    return false;
+}
+
 bool Object::IsUpdateFieldVisible(uint32 flags, bool isSelf, bool isOwner, bool isItemOwner, bool isPartyMember) const
 {
     if (flags == UF_FLAG_NONE)
@@ -1049,29 +1168,41 @@ void Object::_LoadIntoDataField(std::string const& data, uint32 startOffset, uin
     for (uint32 index = 0; index < count; ++index)
     {
         m_uint32Values[startOffset + index] = atol(tokens[index]);
-        _changedFields[startOffset + index] = true;
+        _changedFields.SetBit(startOffset + index);
     }
 }
 
-void Object::_SetUpdateBits(UpdateMask* updateMask, Player* target) const
+void Object::_SetUpdateBits(UpdateMask* updateMask, uint8 visibilityClass) const
 {
-    bool* indexes = _changedFields;
-    uint32* flags = NULL;
-    bool isSelf = target == this;
-    bool isOwner = false;
-    bool isItemOwner = false;
-    bool hasSpecialInfo = false;
-    bool isPartyMember = false;
+    UpdateFieldMasks const& masks = GetUpdateFieldMasks(GetTypeId());
 
-    GetUpdateFieldData(target, flags, isOwner, isItemOwner, hasSpecialInfo, isPartyMember);
+    // fields always sent to this receiver
+    uint32 alwaysFlags = _fieldNotifyFlags;
+    if (visibilityClass & UF_VISIBILITY_SPECIAL_INFO)
+        alwaysFlags |= UF_FLAG_SPECIAL_INFO;
 
-    uint32 valCount = m_valuesCount;
-    if (GetTypeId() == TYPEID_PLAYER && target != this)
-        valCount = PLAYER_END_NOT_SELF;
+    uint32 blockCount = std::min(updateMask->GetBlockCount(), masks.GetBlockCount());
+    uint32 const* changed = _changedFields.GetBlocks();
+    uint32 const* visible = masks.GetVisibleBlocks(visibilityClass);
+    uint32* blocks = updateMask->GetBlocks();
 
-    for (uint16 index = 0; index < valCount; ++index, ++indexes)
-        if (_fieldNotifyFlags & flags[index] || (flags[index] & UF_FLAG_SPECIAL_INFO && hasSpecialInfo) || (*indexes && IsUpdateFieldVisible(flags[index], isSelf, isOwner, isItemOwner, isPartyMember)))
-            updateMask->SetBit(index);
+    for (uint32 block = 0; block < blockCount; ++block)
+        blocks[block] = changed[block] & visible[block];
+
+    for (uint8 i = 0; i < MAX_UF_FLAGS; ++i)
+    {
+        if (!(alwaysFlags & (1 << i)))
+            continue;
+
+        uint32 const* flagBlocks = masks.GetFlagBlocks(i);
+        for (uint32 block = 0; block < blockCount; ++block)
+            blocks[block] |= flagBlocks[block];
+    }
+
+    // the last block may hold fields beyond the sent ones (PLAYER_END_NOT_SELF)
+    if (uint32 tail = updateMask->GetCount() & 31)
+        if (blockCount == updateMask->GetBlockCount())
+            blocks[blockCount - 1] &= (1 << tail) - 1;
 }
 
 void Object::_SetCreateBits(UpdateMask* updateMask, Player* target) const
@@ -1102,13 +1233,9 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1119,13 +1246,9 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1134,7 +1257,7 @@ void Object::UpdateUInt32Value(uint16 index, uint32 value)
     ASSERT(index < m_valuesCount || PrintIndexError(index, true));
 
     m_uint32Values[index] = value;
-    _changedFields[index] = true;
+    _changedFields.SetBit(index);
 }
 
 void Object::SetUInt64Value(uint16 index, uint64 value)
@@ -1144,14 +1267,10 @@ void Object::SetUInt64Value(uint16 index, uint64 value)
     {
         m_uint32Values[index] = PAIR64_LOPART(value);
         m_uint32Values[index + 1] = PAIR64_HIPART(value);
-        _changedFields[index] = true;
-        _changedFields[index + 1] = true;
+        _changedFields.SetBit(index);
+        _changedFields.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1162,14 +1281,10 @@ bool Object::AddUInt64Value(uint16 index, uint64 value)
     {
         m_uint32Values[index] = PAIR64_LOPART(value);
         m_uint32Values[index + 1] = PAIR64_HIPART(value);
-        _changedFields[index] = true;
-        _changedFields[index + 1] = true;
+        _changedFields.SetBit(index);
+        _changedFields.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
 
         return true;
     }
@@ -1184,14 +1299,10 @@ bool Object::RemoveUInt64Value(uint16 index, uint64 value)
     {
         m_uint32Values[index] = 0;
         m_uint32Values[index + 1] = 0;
-        _changedFields[index] = true;
-        _changedFields[index + 1] = true;
+        _changedFields.SetBit(index);
+        _changedFields.SetBit(index + 1);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
 
         return true;
     }
@@ -1206,13 +1317,9 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1230,13 +1337,9 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1254,13 +1357,9 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1321,13 +1420,9 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1342,13 +1437,9 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1365,13 +1456,9 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1388,13 +1475,9 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        _changedFields[index] = true;
+        _changedFields.SetBit(index);
 
-        if (m_inWorld && !m_objectUpdated)
-        {
-            sObjectAccessor->AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -2185,12 +2268,8 @@ void WorldObject::SendPlaySound(uint32 Sound, bool OnlySelf)
 
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
-    _changedFields[i] = true;
-    if (m_inWorld && !m_objectUpdated)
-    {
-        sObjectAccessor->AddUpdateObject(this);
-        m_objectUpdated = true;
-    }
+    _changedFields.SetBit(i);
+    AddToObjectUpdateIfNeeded();
 }
 
 namespace Trinity
@@ -2404,6 +2483,28 @@ void WorldObject::SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr
     VisitNearbyWorldObject(GetVisibilityRange(), notifier);
 }
 
+void WorldObject::SendMessageToObservers(WorldPacket* data, Player const* skipped_rcvr)
+{
+    for (std::set<Player*>::const_iterator itr = m_observers.begin(); itr != m_observers.end(); ++itr)
+    {
+        Player* player = *itr;
+        if (player == skipped_rcvr)
+            continue;
+
+        if (WorldSession* session = player->GetSession())
+            session->SendPacket(data);
+    }
+}
+
+void WorldObject::ClearObservers()
+{
+    // players out of range still have the object at client, it is created again when visible
+    for (std::set<Player*>::const_iterator itr = m_observers.begin(); itr != m_observers.end(); ++itr)
+        (*itr)->m_clientGUIDs.erase(GetGUID());
+
+    m_observers.clear();
+}
+
 void WorldObject::SendObjectDeSpawnAnim(uint64 guid)
 {
     WorldPacket data(SMSG_GAMEOBJECT_DESPAWN_ANIM, 8);
@@ -2422,11 +2523,16 @@ void WorldObject::SetMap(Map* map)
         sLog->outFatal(LOG_FILTER_GENERAL, "WorldObject::SetMap: obj %u new map %u %u, old map %u %u", (uint32)GetTypeId(), map->GetId(), map->GetInstanceId(), m_currMap->GetId(), m_currMap->GetInstanceId());
         ASSERT(false);
     }
+    // only corpses may get here while in world, move their pending update along
+    if (m_objectUpdated)
+        RemoveFromObjectUpdate();
     m_currMap = map;
     m_mapId = map->GetId();
     m_InstanceId = map->GetInstanceId();
     if (IsWorldObject())
         m_currMap->AddWorldObject(this);
+    if (m_objectUpdated)
+        AddToObjectUpdate();
 }
 
 void WorldObject::ResetMap()
@@ -3214,7 +3320,7 @@ void WorldObject::DestroyForNearbyPlayers()
             continue;
 
         DestroyForPlayer(player);
-        player->m_clientGUIDs.erase(GetGUID());
+        player->RemoveClientGUID(this);
     }
 }
 
@@ -3230,6 +3336,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     std::set<uint64> plr_list;
+    UpdateBlockCache i_blockCache;                          // values blocks shared by the receivers of this update
     WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) {}
     void Visit(PlayerMapType &m)
     {
@@ -3287,7 +3394,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            i_object.BuildFieldsUpdate(player, i_updateDatas, &i_blockCache);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -3309,6 +3416,22 @@ void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
     ClearUpdateMask(false);
 }
 
+void WorldObject::AddToObjectUpdate()
+{
+    if (Map* map = FindMap())
+        map->AddUpdateObject(this);
+    else
+        Object::AddToObjectUpdate();
+}
+
+void WorldObject::RemoveFromObjectUpdate()
+{
+    if (Map* map = FindMap())
+        map->RemoveUpdateObject(this);
+    else
+        Object::RemoveFromObjectUpdate();
+}
+
 uint64 WorldObject::GetTransGUID() const
 {
     if (GetTransport())
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateMask.h"
 #include "GridReference.h"
 #include "ObjectDefines.h"
 #include "GridDefines.h"
@@ -109,7 +110,6 @@ class ByteBuffer;
 class WorldSession;
 class Creature;
 class Player;
-class UpdateMask;
 class InstanceScript;
 class GameObject;
 class TempSummon;
@@ -121,6 +121,9 @@ class Transport;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
 
+// values update blocks of one object, by receiver visibility class (see UpdatefieldVisibility)
+typedef std::map<uint8, ByteBuffer> UpdateBlockCache;
+
 //! Structure to ease conversions from single 64 bit integer guid into individual bytes, for packet sending purposes
 //! Nuke this out when porting ObjectGuid from MaNGOS, but preserve the per-byte storage
 struct ObjectGuid
@@ -203,7 +206,7 @@ class Object
         virtual void BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) const;
         void SendUpdateToPlayer(Player* player);
 
-        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, UpdateBlockCache* cache = NULL) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
 
         virtual void DestroyForPlayer(Player* target, bool onDeath = false) const;
@@ -360,12 +363,16 @@ class Object
 
         void ClearUpdateMask(bool remove);
 
+        // queue holding objects with changed fields until their update packets are built
+        virtual void AddToObjectUpdate();
+        virtual void RemoveFromObjectUpdate();
+
         uint16 GetValuesCount() const { return m_valuesCount; }
 
         virtual bool hasQuest(uint32 /* quest_id */) const { return false; }
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
         virtual void BuildUpdate(UpdateDataMapType&) {}
-        void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, UpdateBlockCache* cache = NULL) const;
 
         void SetFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags |= flag; }
         void RemoveFieldNotifyFlag(uint16 flag) { _fieldNotifyFlags &= ~flag; }
@@ -405,7 +412,10 @@ class Object
 
         bool IsUpdateFieldVisible(uint32 flags, bool isSelf, bool isOwner, bool isItemOwner, bool isPartyMember) const;
 
-        void _SetUpdateBits(UpdateMask* updateMask, Player* target) const;
+        uint8 GetUpdateFieldVisibilityClass(Player const* target) const;
+        bool HasTargetDependentValues(UpdateMask const& updateMask) const;
+
+        void _SetUpdateBits(UpdateMask* updateMask, uint8 visibilityClass) const;
         void _SetCreateBits(UpdateMask* updateMask, Player* target) const;
         void _BuildMovementUpdate(ByteBuffer * data, uint16 flags) const;
         void _BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask* updateMask, Player* target) const;
@@ -422,7 +432,7 @@ class Object
             float  *m_floatValues;
         };
 
-        bool* _changedFields;
+        UpdateMask _changedFields;
 
         uint16 m_valuesCount;
 
@@ -430,6 +440,8 @@ class Object
 
         bool m_objectUpdated;
 
+        void AddToObjectUpdateIfNeeded();
+
     private:
         bool m_inWorld;
 
@@ -666,6 +678,7 @@ class WorldObject : public Object, public WorldLocation
                 return;
 
             DestroyForNearbyPlayers();
+            ClearObservers();
 
             Object::RemoveFromWorld();
         }
@@ -824,6 +837,12 @@ class WorldObject : public Object, public WorldLocation
         virtual void SendMessageToSetInRange(WorldPacket* data, float dist, bool self);
         virtual void SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr);
 
+        // sends to the players having the object at client, without searching the grid
+        // as SendMessageToSet does; for frequent packets like movement
+        void SendMessageToObservers(WorldPacket* data, Player const* skipped_rcvr);
+        void AddObserver(Player* player) { m_observers.insert(player); }
+        void RemoveObserver(Player* player) { m_observers.erase(player); }
+
         virtual uint8 getLevelForTarget(WorldObject const* /*target*/) const { return 1; }
 
         void MonsterSay(const char* text, uint32 language, uint64 TargetGuid);
@@ -915,6 +934,8 @@ class WorldObject : public Object, public WorldLocation
         void DestroyForNearbyPlayers();
         virtual void UpdateObjectVisibility(bool forced = true);
         void BuildUpdate(UpdateDataMapType&);
+        void AddToObjectUpdate();
+        void RemoveFromObjectUpdate();
 
         //relocation and visibility system functions
         void AddToNotify(uint16 f) { m_notifyflags |= f;}
@@ -977,9 +998,13 @@ class WorldObject : public Object, public WorldLocation
         virtual bool IsInvisibleGMDueToDespawn(WorldObject const* /*seer*/) const { return false; }      
         //difference from IsAlwaysVisibleFor: 1. after distance check; 2. use owner or charmer as seer
         virtual bool IsAlwaysDetectableFor(WorldObject const* /*seer*/) const { return false; }
+
+        void ClearObservers();
     private:
         Map* m_currMap;                                    //current object's Map location
 
+        std::set<Player*> m_observers;                      // players having the object in m_clientGUIDs
+
         //uint32 m_mapId;                                     // object at map with map_id
         uint32 m_InstanceId;                                // in map copy with instance id
         uint32 m_phaseMask;                                 // in area phase state
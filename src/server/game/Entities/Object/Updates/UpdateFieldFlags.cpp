@@ -1656,3 +1656,33 @@ uint32 AreaTriggerUpdateFieldFlags[AREATRIGGER_END] =
     UF_FLAG_PUBLIC,                                         // AREATRIGGER_FINAL_POS+1
     UF_FLAG_PUBLIC,                                         // AREATRIGGER_FINAL_POS+2
 };
+
+UpdateFieldMasks::UpdateFieldMasks(uint32 const* flags, uint32 count) : _blockCount((count + 31) / 32),
+    _visible(MAX_UF_VISIBILITY_CLASSES * _blockCount, 0), _flags(MAX_UF_FLAGS * _blockCount, 0)
+{
+    for (uint32 index = 0; index < count; ++index)
+    {
+        uint32 bit = 1 << (index & 31);
+        uint32 block = index >> 5;
+
+        for (uint8 i = 0; i < MAX_UF_FLAGS; ++i)
+            if (flags[index] & (1 << i))
+                _flags[i * _blockCount + block] |= bit;
+
+        for (uint8 visibilityClass = 0; visibilityClass < MAX_UF_VISIBILITY_CLASSES; ++visibilityClass)
+        {
+            uint32 visibleFlags = UF_FLAG_PUBLIC;
+            if (visibilityClass & UF_VISIBILITY_SELF)
+                visibleFlags |= UF_FLAG_PRIVATE;
+            if (visibilityClass & UF_VISIBILITY_OWNER)
+                visibleFlags |= UF_FLAG_OWNER;
+            if (visibilityClass & UF_VISIBILITY_ITEM_OWNER)
+                visibleFlags |= UF_FLAG_ITEM_OWNER;
+            if (visibilityClass & UF_VISIBILITY_PARTY_MEMBER)
+                visibleFlags |= UF_FLAG_PARTY_MEMBER;
+
+            if (flags[index] & visibleFlags)
+                _visible[visibilityClass * _blockCount + block] |= bit;
+        }
+    }
+}
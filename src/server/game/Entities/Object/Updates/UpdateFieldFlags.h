@@ -20,6 +20,7 @@
 
 #include "UpdateFields.h"
 #include "Define.h"
+#include <vector>
 
 enum UpdatefieldFlags
 {
@@ -35,6 +36,40 @@ enum UpdatefieldFlags
     UF_FLAG_DYNAMIC      = 0x100
 };
 
+#define MAX_UF_FLAGS 9
+
+// Which of the visibility restricted fields a receiver can see
+enum UpdatefieldVisibility
+{
+    UF_VISIBILITY_SELF          = 0x01,
+    UF_VISIBILITY_OWNER         = 0x02,
+    UF_VISIBILITY_ITEM_OWNER    = 0x04,
+    UF_VISIBILITY_PARTY_MEMBER  = 0x08,
+    UF_VISIBILITY_SPECIAL_INFO  = 0x10,
+
+    MAX_UF_VISIBILITY_CLASSES   = 0x20
+};
+
+// One field flags table as update mask blocks, per flag and per visibility class
+class UpdateFieldMasks
+{
+    public:
+        UpdateFieldMasks(uint32 const* flags, uint32 count);
+
+        uint32 GetBlockCount() const { return _blockCount; }
+
+        // fields sent when changed to a receiver of the class
+        uint32 const* GetVisibleBlocks(uint8 visibilityClass) const { return &_visible[visibilityClass * _blockCount]; }
+
+        // fields having the flag
+        uint32 const* GetFlagBlocks(uint8 flagIndex) const { return &_flags[flagIndex * _blockCount]; }
+
+    private:
+        uint32 _blockCount;
+        std::vector<uint32> _visible;
+        std::vector<uint32> _flags;
+};
+
 extern uint32 ItemUpdateFieldFlags[CONTAINER_END];
 extern uint32 UnitUpdateFieldFlags[PLAYER_END];
 extern uint32 GameObjectUpdateFieldFlags[GAMEOBJECT_END];
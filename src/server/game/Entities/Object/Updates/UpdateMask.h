@@ -52,6 +52,8 @@ class UpdateMask
         uint32 GetLength() const { return mBlocks << 2; }
         uint32 GetCount() const { return mCount; }
         uint8* GetMask() { return (uint8*)mUpdateMask; }
+        uint32* GetBlocks() { return mUpdateMask; }
+        uint32 const* GetBlocks() const { return mUpdateMask; }
 
         void SetCount (uint32 valuesCount)
         {
@@ -791,6 +791,7 @@ Player::Player(WorldSession* session): Unit(true), phaseMgr(this)
     m_areaUpdateId = 0;
 
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_saveDeferredSince = 0;
 
     _resurrectionData = NULL;
 
@@ -1868,10 +1869,18 @@ void Player::Update(uint32 p_time)
     {
         if (p_time >= m_nextSave)
         {
-            // m_nextSave reset in SaveToDB call
-            sScriptMgr->OnPlayerSave(this);
-            SaveToDB();
-            sLog->outDebug(LOG_FILTER_PLAYER, "Player '%s' (GUID: %u) saved", GetName().c_str(), GetGUIDLow());
+            // a deferred save is retried after a random slice of the interval, so the saves
+            // postponed together do not all run in the same later tick. It is forced on the first
+            // retry once WorldUpdate.MaxDeferredTicks updates passed since it was due.
+            if (sWorld->GetTickBudget().DeferSince(DEFERRABLE_AUTOSAVES, m_saveDeferredSince))
+                m_nextSave = urand(1, std::max<uint32>(1, sWorld->getIntConfig(CONFIG_INTERVAL_SAVE) / 100));
+            else
+            {
+                // m_nextSave reset in SaveToDB call
+                sScriptMgr->OnPlayerSave(this);
+                SaveToDB();
+                sLog->outDebug(LOG_FILTER_PLAYER, "Player '%s' (GUID: %u) saved", GetName().c_str(), GetGUIDLow());
+            }
         }
         else
             m_nextSave -= p_time;
@@ -2566,6 +2575,9 @@ void Player::RemoveFromWorld()
         UnsummonPetTemporaryIfAny();
         sOutdoorPvPMgr->HandlePlayerLeaveZone(this, m_zoneUpdateId);
         sBattlefieldMgr->HandlePlayerLeaveZone(this, m_zoneUpdateId);
+
+        ///- Stop receiving the messages of the objects seen so far
+        ClearClientGUIDs();
     }
 
     ///- Do not add/remove the player from the object storage
@@ -6194,6 +6206,7 @@ bool Player::UpdateSkill(uint32 skill_id, uint32 step)
         if (itr->second.uState != SKILL_NEW)
             itr->second.uState = SKILL_CHANGED;
 
+        UpdateGuildProfessions(skill_id);
         UpdateSkillEnchantments(skill_id, value, new_value);
         UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL, skill_id);
         UpdateGuildAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL, skill_id);
@@ -6373,6 +6386,8 @@ bool Player::UpdateSkillPro(uint16 skillId, int32 chance, uint32 step)
     if (itr->second.uState != SKILL_NEW)
         itr->second.uState = SKILL_CHANGED;
 
+    UpdateGuildProfessions(skillId);
+
     for (size_t i = 0; i < bonusSkillLevelsSize; ++i)
     {
         uint32 bsl = bonusSkillLevels[i];
@@ -6477,6 +6492,8 @@ void Player::SetSkill(uint16 id, uint16 step, uint16 newVal, uint16 maxVal)
     if (!id)
         return;
 
+    UpdateGuildProfessions(id);
+
     uint16 currVal;
     SkillStatusMap::iterator itr = mSkillStatus.find(id);
 
@@ -6922,6 +6939,14 @@ void Player::SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr)
     VisitNearbyWorldObject(GetVisibilityRange(), notifier);
 }
 
+void Player::SendMessageToObservers(WorldPacket* data, Player const* skipped_rcvr)
+{
+    if (skipped_rcvr != this)
+        GetSession()->SendPacket(data);
+
+    WorldObject::SendMessageToObservers(data, skipped_rcvr);
+}
+
 void Player::SendDirectMessage(WorldPacket* data)
 {
     m_session->SendPacket(data);
@@ -22934,30 +22959,30 @@ bool Player::IsVisibleGloballyFor(Player const* u) const
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, T* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player* player, T* target, std::set<Unit*>& /*v*/)
 {
-    s64.insert(target->GetGUID());
+    player->AddClientGUID(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player* player, GameObject* target, std::set<Unit*>& /*v*/)
 {
     // Don't update only GAMEOBJECT_TYPE_TRANSPORT (or all transports and destructible buildings?)
     if ((target->GetGOInfo()->type != GAMEOBJECT_TYPE_TRANSPORT))
-        s64.insert(target->GetGUID());
+        player->AddClientGUID(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Creature* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player* player, Creature* target, std::set<Unit*>& v)
 {
-    s64.insert(target->GetGUID());
+    player->AddClientGUID(target);
     v.insert(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Player* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player* player, Player* target, std::set<Unit*>& v)
 {
-    s64.insert(target->GetGUID());
+    player->AddClientGUID(target);
     v.insert(target);
 }
 
@@ -22983,7 +23008,7 @@ void Player::UpdateVisibilityOf(WorldObject* target)
                 BeforeVisibilityDestroy<Creature>(target->ToCreature(), this);
 
             target->DestroyForPlayer(this);
-            m_clientGUIDs.erase(target->GetGUID());
+            RemoveClientGUID(target);
 
             #ifdef TRINITY_DEBUG
                 sLog->outDebug(LOG_FILTER_MAPS, "Object %u (Type: %u) out of range for player %u. Distance = %f", target->GetGUIDLow(), target->GetTypeId(), GetGUIDLow(), GetDistance(target));
@@ -22998,7 +23023,7 @@ void Player::UpdateVisibilityOf(WorldObject* target)
             //    UpdateVisibilityOf(((Unit*)target)->m_Vehicle);
 
             target->SendUpdateToPlayer(this);
-            m_clientGUIDs.insert(target->GetGUID());
+            AddClientGUID(target);
 
             #ifdef TRINITY_DEBUG
                 sLog->outDebug(LOG_FILTER_MAPS, "Object %u (Type: %u) is visible now for player %u. Distance = %f", target->GetGUIDLow(), target->GetTypeId(), GetGUIDLow(), GetDistance(target));
@@ -23012,6 +23037,37 @@ void Player::UpdateVisibilityOf(WorldObject* target)
     }
 }
 
+void Player::AddClientGUID(WorldObject* target)
+{
+    m_clientGUIDs.insert(target->GetGUID());
+    target->AddObserver(this);
+}
+
+void Player::RemoveClientGUID(WorldObject* target)
+{
+    m_clientGUIDs.erase(target->GetGUID());
+    target->RemoveObserver(this);
+}
+
+void Player::RemoveClientGUID(uint64 guid)
+{
+    if (!m_clientGUIDs.erase(guid))
+        return;
+
+    // objects no longer found have left the world and cleared their observers already
+    if (WorldObject* target = ObjectAccessor::GetWorldObject(*this, guid))
+        target->RemoveObserver(this);
+}
+
+void Player::ClearClientGUIDs()
+{
+    for (ClientGUIDs::const_iterator itr = m_clientGUIDs.begin(); itr != m_clientGUIDs.end(); ++itr)
+        if (WorldObject* target = ObjectAccessor::GetWorldObject(*this, *itr))
+            target->RemoveObserver(this);
+
+    m_clientGUIDs.clear();
+}
+
 void Player::UpdateTriggerVisibility()
 {
     if (m_clientGUIDs.empty())
@@ -23058,7 +23114,7 @@ void Player::UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& vi
             BeforeVisibilityDestroy<T>(target, this);
 
             target->BuildOutOfRangeUpdateBlock(&data);
-            m_clientGUIDs.erase(target->GetGUID());
+            RemoveClientGUID(target);
 
             #ifdef TRINITY_DEBUG
                 sLog->outDebug(LOG_FILTER_MAPS, "Object %u (Type: %u, Entry: %u) is out of range for player %u. Distance = %f", target->GetGUIDLow(), target->GetTypeId(), target->GetEntry(), GetGUIDLow(), GetDistance(target));
@@ -23073,7 +23129,7 @@ void Player::UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& vi
             //    UpdateVisibilityOf(((Unit*)target)->m_Vehicle, data, visibleNow);
 
             target->BuildCreateUpdateBlockForPlayer(&data, this);
-            UpdateVisibilityOf_helper(m_clientGUIDs, target, visibleNow);
+            UpdateVisibilityOf_helper(this, target, visibleNow);
 
             #ifdef TRINITY_DEBUG
                 sLog->outDebug(LOG_FILTER_MAPS, "Object %u (Type: %u, Entry: %u) is visible now for player %u. Distance = %f", target->GetGUIDLow(), target->GetTypeId(), target->GetEntry(), GetGUIDLow(), GetDistance(target));
@@ -23927,7 +23983,7 @@ void Player::UpdateForQuestWorldObjects()
     {
         if (IS_GAMEOBJECT_GUID(*itr))
         {
-            if (GameObject* obj = HashMapHolder<GameObject>::Find(*itr))
+            if (GameObject* obj = GetMap()->GetGameObject(*itr))
                 obj->BuildValuesUpdateBlockForPlayer(&udata, this);
         }
         else if (IS_CRE_OR_VEH_GUID(*itr))
@@ -25561,6 +25617,16 @@ void Player::UpdateGuildAchievementCriteria(AchievementCriteriaTypes type, uint6
     guild->GetAchievementMgr().UpdateAchievementCriteria(type, miscValue1, miscValue2, miscValue3, unit, this);
  }
 
+// Guild member professions are recalculated from the skills on the next guild save
+void Player::UpdateGuildProfessions(uint32 skillId)
+{
+    if (!IsPrimaryProfessionSkill(skillId))
+        return;
+
+    if (Guild* guild = sGuildMgr->GetGuildById(GetGuildId()))
+        guild->SetProfessionsOutdatedFor(GetGUID());
+}
+
 void Player::CompletedAchievement(AchievementEntry const* entry)
 {
     m_achievementMgr->CompletedAchievement(entry, this);
@@ -1235,6 +1235,7 @@ private:
 class Player : public Unit, public GridObject<Player>
 {
     friend class WorldSession;
+    friend class MailExpiryEvent;
     friend void Item::AddToUpdateQueueOf(Player* player);
     friend void Item::RemoveFromUpdateQueueOf(Player* player);
     public:
@@ -2218,6 +2219,7 @@ class Player : public Unit, public GridObject<Player>
         void SendMessageToSetInRange(WorldPacket* data, float fist, bool self);// overwrite Object::SendMessageToSetInRange
         void SendMessageToSetInRange(WorldPacket* data, float dist, bool self, bool own_team_only);
         void SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr);
+        void SendMessageToObservers(WorldPacket* data, Player const* skipped_rcvr);
 
         Corpse* GetCorpse() const;
         void SpawnCorpseBones();
@@ -2597,6 +2599,12 @@ class Player : public Unit, public GridObject<Player>
 
         bool HaveAtClient(WorldObject const* u) const { return u == this || m_clientGUIDs.find(u->GetGUID()) != m_clientGUIDs.end(); }
 
+        // keep the observers of the objects (WorldObject::SendMessageToObservers) in sync with m_clientGUIDs
+        void AddClientGUID(WorldObject* target);
+        void RemoveClientGUID(WorldObject* target);
+        void RemoveClientGUID(uint64 guid);
+        void ClearClientGUIDs();
+
         bool IsNeverVisible() const;
 
         bool IsVisibleGloballyFor(Player const* player) const;
@@ -2750,6 +2758,7 @@ class Player : public Unit, public GridObject<Player>
         void ResetAchievementCriteria(AchievementCriteriaTypes type, uint64 miscValue1 = 0, uint64 miscValue2 = 0, bool evenIfCriteriaComplete = false);
         void UpdateAchievementCriteria(AchievementCriteriaTypes type, uint64 miscValue1 = 0, uint64 miscValue2 = 0, uint64 miscValue3 = 0, Unit* unit = NULL);
         void UpdateGuildAchievementCriteria(AchievementCriteriaTypes type, uint64 miscValue1 = 0, uint64 miscValue2 = 0, uint64 miscValue3 = 0, Unit* unit = NULL);
+        void UpdateGuildProfessions(uint32 skillId);
         void StartTimedAchievement(AchievementCriteriaTimedTypes type, uint32 entry, uint32 timeLost = 0);
         void RemoveTimedAchievement(AchievementCriteriaTimedTypes type, uint32 entry);
         void CompletedAchievement(AchievementEntry const* entry);
@@ -2990,6 +2999,7 @@ class Player : public Unit, public GridObject<Player>
 
         uint32 m_team;
         uint32 m_nextSave;
+        uint32 m_saveDeferredSince;                         // tick the due autosave was first postponed in by the tick budget, see TickBudget::DeferSince
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
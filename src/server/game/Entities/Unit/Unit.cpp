@@ -3538,7 +3538,7 @@ void Unit::RemoveOwnedAura(AuraMap::iterator &i, AuraRemoveMode removeMode)
     {
         Unit* temp = aura->GetCaster();
         if (!temp)
-            temp = ObjectAccessor::GetObjectInOrOutOfWorld(aura->GetCasterGUID(), (Unit*)NULL);
+            temp = ObjectAccessor::GetUnitInOrOutOfWorld(*this, aura->GetCasterGUID());
         if (temp)
         {
             ACE_Guard<ACE_Recursive_Thread_Mutex> g(m_appliedAuraMutex);
@@ -1147,10 +1147,12 @@ void GameEventMgr::UpdateEventNPCFlags(uint16 event_id)
         // get the creature data from the low guid to get the entry, to be able to find out the whole guid
         if (CreatureData const* data = sObjectMgr->GetCreatureData(itr->first))
         {
-            Creature* cr = HashMapHolder<Creature>::Find(MAKE_NEW_GUID(itr->first, data->id, HIGHGUID_UNIT));
-            // if we found the creature, modify its npcflag
-            if (cr)
+            std::vector<Creature*> creatures;
+            ObjectAccessor::FindSpawnedCreatures(MAKE_NEW_GUID(itr->first, data->id, HIGHGUID_UNIT), creatures);
+            // modify the npcflag of every spawned copy of the creature
+            for (std::vector<Creature*>::const_iterator cItr = creatures.begin(); cItr != creatures.end(); ++cItr)
             {
+                Creature* cr = *cItr;
                 uint32 npcflag = GetNPCFlag(cr);
                 if (const CreatureTemplate* ci = cr->GetCreatureTemplate())
                     npcflag |= ci->npcflag;
@@ -1278,8 +1280,10 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
         {
             sObjectMgr->RemoveCreatureFromGrid(*itr, data);
 
-            if (Creature* creature = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(*itr, data->id, HIGHGUID_UNIT), (Creature*)NULL))
-                creature->AddObjectToRemoveList();
+            std::vector<Creature*> creatures;
+            ObjectAccessor::FindSpawnedCreatures(MAKE_NEW_GUID(*itr, data->id, HIGHGUID_UNIT), creatures);
+            for (std::vector<Creature*>::const_iterator cItr = creatures.begin(); cItr != creatures.end(); ++cItr)
+                (*cItr)->AddObjectToRemoveList();
         }
     }
 
@@ -1300,8 +1304,10 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
         {
             sObjectMgr->RemoveGameobjectFromGrid(*itr, data);
 
-            if (GameObject* pGameobject = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(*itr, data->id, HIGHGUID_GAMEOBJECT), (GameObject*)NULL))
-                pGameobject->AddObjectToRemoveList();
+            std::vector<GameObject*> gameobjects;
+            ObjectAccessor::FindSpawnedGameObjects(MAKE_NEW_GUID(*itr, data->id, HIGHGUID_GAMEOBJECT), gameobjects);
+            for (std::vector<GameObject*>::const_iterator gItr = gameobjects.begin(); gItr != gameobjects.end(); ++gItr)
+                (*gItr)->AddObjectToRemoveList();
         }
     }
     if (internal_event_id < 0 || internal_event_id >= int32(mGameEventPoolIds.size()))
@@ -1326,7 +1332,7 @@ void GameEventMgr::ChangeEquipOrModel(int16 event_id, bool activate)
             continue;
 
         // Update if spawned
-        Creature* creature = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(itr->first, data->id, HIGHGUID_UNIT), (Creature*)NULL);
+        Creature* creature = ObjectAccessor::FindSpawnedCreature(MAKE_NEW_GUID(itr->first, data->id, HIGHGUID_UNIT));
         if (creature)
         {
             if (activate)
@@ -1632,17 +1638,17 @@ void GameEventMgr::RunSmartAIScripts(uint16 event_id, bool activate)
 {
     //! Iterate over every supported source type (creature and gameobject)
     //! Not entirely sure how this will affect units in non-loaded grids.
+    std::vector<Map*> maps;
+    sMapMgr->GetAllMaps(maps);
+    for (std::vector<Map*>::const_iterator map = maps.begin(); map != maps.end(); ++map)
     {
-        TRINITY_READ_GUARD(HashMapHolder<Creature>::LockType, *HashMapHolder<Creature>::GetLock());
-        HashMapHolder<Creature>::MapType const& m = ObjectAccessor::GetCreatures();
-        for (HashMapHolder<Creature>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
+        MapObjectStore<Creature>::ContainerType const& creatures = (*map)->GetCreatures();
+        for (MapObjectStore<Creature>::ContainerType::const_iterator iter = creatures.begin(); iter != creatures.end(); ++iter)
             if (iter->second->IsInWorld())
                 iter->second->AI()->sOnGameEvent(activate, event_id);
-    }
-    {
-        TRINITY_READ_GUARD(HashMapHolder<GameObject>::LockType, *HashMapHolder<GameObject>::GetLock());
-        HashMapHolder<GameObject>::MapType const& m = ObjectAccessor::GetGameObjects();
-        for (HashMapHolder<GameObject>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
+
+        MapObjectStore<GameObject>::ContainerType const& gameObjects = (*map)->GetGameObjects();
+        for (MapObjectStore<GameObject>::ContainerType::const_iterator iter = gameObjects.begin(); iter != gameObjects.end(); ++iter)
             if (iter->second->IsInWorld())
                 iter->second->AI()->OnGameEvent(activate, event_id);
     }
@@ -1,8 +1,63 @@
 #include "InfoMgr.h"
+#include "Config.h"
+
+#include <ace/Task.h>
+
+// Loads the base data of all characters in guid ranges, every thread querying
+// through its own synchronous connection of the character database
+class InfoCharLoader : public ACE_Task_Base
+{
+    public:
+        explicit InfoCharLoader(uint32 maxGuid) : _maxGuid(maxGuid), _nextRange(0), _threaded(false) { }
+
+        void Run(size_t threads)
+        {
+            if (threads > 1 && _maxGuid >= RangeSize)
+            {
+                _threaded = true;
+                if (activate(THR_NEW_LWP | THR_JOINABLE, int(threads)) == 0)
+                {
+                    wait();
+                    return;
+                }
+
+                _threaded = false;
+            }
+
+            svc();
+        }
+
+        int svc()
+        {
+            if (_threaded)
+                MySQL::Thread_Init();
+
+            for (;;)
+            {
+                uint64 begin = uint64(_nextRange++) * RangeSize;
+                if (begin > _maxGuid)
+                    break;
+
+                sInfoMgr->_LoadCharBase(uint32(begin), uint32(std::min<uint64>(begin + RangeSize, uint64(_maxGuid) + 1)));
+            }
+
+            if (_threaded)
+                MySQL::Thread_End();
+
+            return 0;
+        }
+
+    private:
+        static uint32 const RangeSize = 100000;
+
+        uint32 _maxGuid;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> _nextRange;
+        bool _threaded;
+};
 
 void InfoMgr::Initialize()
 {
-    ASSERT(m_charInfos.size() == 0);
+    ASSERT(GetCharCount() == 0);
 
     sLog->outInfo(LOG_FILTER_SERVER_LOADING, "\n\nInitializing InfoMgr...");
     uint32 count;
@@ -10,18 +65,16 @@ void InfoMgr::Initialize()
 
     // General stuff
     uint32 start = allStart;
-    count = 0;
-    if (QueryResult result = CharacterDatabase.Query("SELECT guid, name, race, gender, class, account, level, zone FROM characters WHERE account != 0"))
-    {
-        do
-        {
-            Field *fields = result->Fetch();
-            UpdateCharBase(fields[0].GetUInt32() /* guid */, fields[1].GetString() /* name */, fields[3].GetUInt8() /*gender*/,
-                fields[2].GetUInt8() /*race*/, fields[4].GetUInt8() /*class*/, fields[5].GetUInt32() /* account */, fields[6].GetUInt8() /* level */, fields[7].GetUInt16() /* zone */);
-            ++count;
-        } while (result->NextRow());
-    }
-    sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> Loaded base for %u characters (%ums)", count, GetMSTimeDiffToNow(start));
+    uint32 maxGuid = 0;
+    if (QueryResult result = CharacterDatabase.Query("SELECT MAX(guid) FROM characters"))
+        maxGuid = (*result)[0].GetUInt32();
+
+    // all chunks are allocated up front so the loader threads only write their own slots
+    _ReserveSlots(maxGuid);
+
+    InfoCharLoader loader(maxGuid);
+    loader.Run(size_t(std::max(ConfigMgr::GetIntDefault("CharacterDatabase.SynchThreads", 2), 1)));
+    sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> Loaded base for %u characters (%ums)", GetCharCount(), GetMSTimeDiffToNow(start));
 
     // MMR
     start = getMSTime();
@@ -152,62 +205,127 @@ void InfoMgr::Initialize()
     // remove this if you want to use petsMap, f.i. find SavedPet by Guid
     petsMap.clear();*/
 
-    sLog->outInfo(LOG_FILTER_SERVER_LOADING, "Done initializing InfoMgr. (%ums)", GetMSTimeDiffToNow(allStart));
+    sLog->outInfo(LOG_FILTER_SERVER_LOADING, "Done initializing InfoMgr, %u characters in %u KB. (%ums)", GetCharCount(), uint32(GetMemoryUsage() / 1024), GetMSTimeDiffToNow(allStart));
 
 }
 
-bool InfoMgr::GetCharInfo(uint32 guid, InfoCharEntry &info)
+InfoMgr::InfoMgr() : m_charChunks(MaxCharChunks, (CharSlot*)NULL), m_charChunkCount(0), m_charCount(0)
 {
-    ACE_Read_Guard<ACE_Thread_Mutex> g(m_charMutex);
+}
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
+InfoMgr::~InfoMgr()
+{
+    for (std::vector<CharSlot*>::iterator itr = m_charChunks.begin(); itr != m_charChunks.end(); ++itr)
+        delete[] *itr;
+}
+
+size_t InfoMgr::GetMemoryUsage() const
+{
+    // names are counted with their hash node, longer ones have a heap buffer on top
+    return m_charChunks.capacity() * sizeof(CharSlot*)
+        + size_t(m_charChunkCount.value()) * CharChunkSize * sizeof(CharSlot)
+        + _GetNameCount() * (sizeof(CharInfoNameMap::value_type) + 2 * sizeof(void*));
+}
+
+InfoMgr::CharSlot* InfoMgr::_FindSlot(uint32 guid) const
+{
+    CharSlot* chunk = m_charChunks[guid >> CharChunkBits];
+    return chunk ? &chunk[guid & (CharChunkSize - 1)] : NULL;
+}
+
+InfoMgr::CharSlot* InfoMgr::_CreateSlot(uint32 guid)
+{
+    CharSlot*& chunk = m_charChunks[guid >> CharChunkBits];
+    if (!chunk)
     {
-        memcpy(&info, itr->second, sizeof(info));
-        return true;
+        CharSlot* newChunk = new CharSlot[CharChunkSize];
+        // atomic increment is a full barrier, readers finding the chunk see its slots constructed
+        ++m_charChunkCount;
+        chunk = newChunk;
     }
 
-    return false;
+    return &chunk[guid & (CharChunkSize - 1)];
 }
 
-bool InfoMgr::GetCharInfo(std::string name, InfoCharEntry &info)
+void InfoMgr::_ReserveSlots(uint32 maxGuid)
+{
+    for (uint64 guid = 0; guid <= maxGuid; guid += CharChunkSize)
+        _CreateSlot(uint32(guid));
+}
+
+bool InfoMgr::_ReadSlot(CharSlot& slot, InfoCharEntry &info)
+{
+    for (;;)
+    {
+        // reading through an atomic add keeps the copy between both reads of the sequence
+        long sequence = (slot.Sequence += 0);
+        if (sequence & 1)
+        {
+            ACE_OS::thr_yield();
+            continue;
+        }
+
+        memcpy(&info, &slot.Info, sizeof(info));
+
+        if ((slot.Sequence += 0) == sequence)
+            return info.Guid != 0;
+    }
+}
+
+bool InfoMgr::GetCharInfo(uint32 guid, InfoCharEntry &info)
 {
-    ACE_Read_Guard<ACE_Thread_Mutex> g(m_charMutex);
+    CharSlot* slot = _FindSlot(guid);
+    return slot && _ReadSlot(*slot, info);
+}
 
-    std::string tmpname = name;
-    if (!normalizePlayerName(tmpname))
+bool InfoMgr::GetCharInfo(std::string name, InfoCharEntry &info)
+{
+    if (!normalizePlayerName(name))
         return false;
 
-    CharInfoNameItr itr = m_charInfosName.find(tmpname);
-    if (itr != m_charInfosName.end())
+    uint32 guid;
     {
-        memcpy(&info, itr->second, sizeof(info));
-        return true;
+        CharNameShard& shard = _GetNameShard(name);
+        ACE_Read_Guard<ACE_RW_Thread_Mutex> g(shard.lock);
+
+        CharInfoNameItr itr = shard.names.find(name);
+        if (itr == shard.names.end())
+            return false;
+
+        guid = itr->second;
     }
 
-    return false;
+    return GetCharInfo(guid, info) && info.Guid == guid;
 }
 
 void InfoMgr::RemoveCharInfo(uint32 guid)
 {
     ACE_Guard<ACE_Thread_Mutex> g(m_charMutex);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-    {
-        _RemoveName(std::string(itr->second->Name));
-        delete itr->second;
-        m_charInfos.erase(itr);
-    }
+    CharSlot* slot = _FindSlot(guid);
+    if (!slot || !slot->Info.Guid)
+        return;
+
+    _RemoveName(std::string(slot->Info.Name), guid);
+
+    _BeginWrite(*slot);
+    memset(&slot->Info, 0, sizeof(slot->Info));
+    _EndWrite(*slot);
+
+    --m_charCount;
 }
 
 void InfoMgr::UpdateCharLevel(uint32 guid, uint8 level)
 {
     ACE_Guard<ACE_Thread_Mutex> g(m_charMutex);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-        itr->second->Level = level;
+    CharSlot* slot = _FindSlot(guid);
+    if (!slot || !slot->Info.Guid)
+        return;
+
+    _BeginWrite(*slot);
+    slot->Info.Level = level;
+    _EndWrite(*slot);
 }
 
 void InfoMgr::UpdateCharArenaTeam(uint32 guid, uint32 team, uint8 slot)
@@ -216,9 +334,13 @@ void InfoMgr::UpdateCharArenaTeam(uint32 guid, uint32 team, uint8 slot)
 
     ASSERT(slot < MAX_ARENA_SLOT);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-        itr->second->ArenaTeam[slot] = team;
+    CharSlot* charSlot = _FindSlot(guid);
+    if (!charSlot || !charSlot->Info.Guid)
+        return;
+
+    _BeginWrite(*charSlot);
+    charSlot->Info.ArenaTeam[slot] = team;
+    _EndWrite(*charSlot);
 }
 
 void InfoMgr::UpdateCharMMR(uint32 guid, uint32 mmr, uint8 slot)
@@ -227,95 +349,140 @@ void InfoMgr::UpdateCharMMR(uint32 guid, uint32 mmr, uint8 slot)
 
     ASSERT(slot < MAX_ARENA_SLOT);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-        itr->second->MMR[slot] = mmr;
+    CharSlot* charSlot = _FindSlot(guid);
+    if (!charSlot || !charSlot->Info.Guid)
+        return;
+
+    _BeginWrite(*charSlot);
+    charSlot->Info.MMR[slot] = mmr;
+    _EndWrite(*charSlot);
 }
 
 void InfoMgr::UpdateCharGroup(uint32 guid, uint32 group)
 {
     ACE_Guard<ACE_Thread_Mutex> g(m_charMutex);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-        itr->second->Group = group;
+    CharSlot* slot = _FindSlot(guid);
+    if (!slot || !slot->Info.Guid)
+        return;
+
+    _BeginWrite(*slot);
+    slot->Info.Group = group;
+    _EndWrite(*slot);
 }
 
 void InfoMgr::UpdateCharGuild(uint32 guid, uint32 guild)
 {
     ACE_Guard<ACE_Thread_Mutex> g(m_charMutex);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-        itr->second->Guild = guild;
+    CharSlot* slot = _FindSlot(guid);
+    if (!slot || !slot->Info.Guid)
+        return;
+
+    _BeginWrite(*slot);
+    slot->Info.Guild = guild;
+    _EndWrite(*slot);
 }
 
-void InfoMgr::UpdateCharBase(uint32 guid, std::string name, uint8 gender, uint8 race, uint8 cclass, uint32 account, uint8 level, uint16 zone, uint8 XPfactor)
+void InfoMgr::UpdateCharBase(uint32 guid, std::string name, uint8 gender, uint8 race, uint8 cclass, uint32 account, uint8 level, uint16 zone, uint8 /*XPfactor*/)
 {
     ACE_Guard<ACE_Thread_Mutex> g(m_charMutex);
 
-    CharInfoItr itr = m_charInfos.find(guid);
-    if (itr != m_charInfos.end())
-    {
-        itr->second->Guid = guid;
-        if (gender != GENDER_NONE)
-            itr->second->Gender = gender;
-        if (race)
-            itr->second->Race = race;
-        if (cclass)
-            itr->second->Class = cclass;
-        if (account)
-            itr->second->Account = account;
-        if (level)
-            itr->second->Level = level;
-        if (zone)
-            itr->second->Zone = zone;
-
-        if (memcmp(itr->second->Name, name.c_str(), name.size()))
-        {
-            _RemoveName(std::string(itr->second->Name));
-            _AddName(name, itr->second);
-        }
+    _SetCharBase(*_CreateSlot(guid), guid, name, gender, race, cclass, account, level, zone);
+}
 
-        memset(itr->second->Name, 0, MAX_INFOCHAR_NAME_LENGTH);
-        memcpy(itr->second->Name, name.c_str(), name.size());
-    }
-    else
+void InfoMgr::_SetCharBase(CharSlot& slot, uint32 guid, std::string const& name, uint8 gender, uint8 race, uint8 cclass, uint32 account, uint8 level, uint16 zone)
+{
+    InfoCharEntry& info = slot.Info;
+    bool isNew = !info.Guid;
+
+    // always re-added, a character created with the same name meanwhile may have taken it over
+    if (!isNew)
+        _RemoveName(std::string(info.Name), guid);
+
+    _BeginWrite(slot);
+
+    info.Guid = guid;
+    if (gender != GENDER_NONE)
+        info.Gender = gender;
+    if (race)
+        info.Race = race;
+    if (cclass)
+        info.Class = cclass;
+    if (account)
+        info.Account = account;
+    if (level)
+        info.Level = level;
+    if (zone)
+        info.Zone = zone;
+
+    memset(info.Name, 0, MAX_INFOCHAR_NAME_LENGTH);
+    memcpy(info.Name, name.c_str(), std::min<size_t>(name.size(), MAX_INFOCHAR_NAME_LENGTH - 1));
+
+    _EndWrite(slot);
+
+    _AddName(name, guid);
+
+    if (isNew)
+        ++m_charCount;
+}
+
+void InfoMgr::_LoadCharBase(uint32 beginGuid, uint32 endGuid)
+{
+    QueryResult result = CharacterDatabase.PQuery("SELECT guid, name, race, gender, class, account, level, zone FROM characters WHERE account != 0 AND guid >= %u AND guid < %u", beginGuid, endGuid);
+    if (!result)
+        return;
+
+    do
     {
-        InfoCharEntry *info = new InfoCharEntry();
-        info->Guid = guid;
-        if (account)
-            info->Account = account;
-        if (gender != GENDER_NONE)
-            info->Gender = gender;
-        if (race)
-            info->Race = race;
-        if (cclass)
-            info->Class = cclass;
-        if (zone)
-            info->Zone = zone;
-        if (level)
-            info->Level = level;
-        
-        memset(info->Name, 0, MAX_INFOCHAR_NAME_LENGTH);
-        memcpy(info->Name, name.c_str(), name.size());
-
-        _AddName(name, info);
-
-        m_charInfos[guid] = info;
-    }
+        Field *fields = result->Fetch();
+        uint32 guid = fields[0].GetUInt32();
+
+        // slots were reserved up to the highest guid, every loader thread owns its own guid range
+        if (CharSlot* slot = _FindSlot(guid))
+            _SetCharBase(*slot, guid, fields[1].GetString(), fields[3].GetUInt8() /*gender*/, fields[2].GetUInt8() /*race*/, fields[4].GetUInt8() /*class*/,
+                fields[5].GetUInt32() /*account*/, fields[6].GetUInt8() /*level*/, fields[7].GetUInt16() /*zone*/);
+    } while (result->NextRow());
+}
+
+void InfoMgr::_AddName(std::string name, uint32 guid)
+{
+    if (!normalizePlayerName(name))
+        return;
+
+    CharNameShard& shard = _GetNameShard(name);
+    ACE_Write_Guard<ACE_RW_Thread_Mutex> g(shard.lock);
+    shard.names[name] = guid;
 }
 
-void InfoMgr::_AddName(std::string name, InfoCharEntry *info)
+void InfoMgr::_RemoveName(std::string name, uint32 guid)
 {
-    m_charInfosName[name] = info;
+    if (!normalizePlayerName(name))
+        return;
+
+    CharNameShard& shard = _GetNameShard(name);
+    ACE_Write_Guard<ACE_RW_Thread_Mutex> g(shard.lock);
+    CharInfoNameItr itr = shard.names.find(name);
+    if (itr != shard.names.end() && itr->second == guid)
+        shard.names.erase(itr);
+}
+
+InfoMgr::CharNameShard& InfoMgr::_GetNameShard(std::string const& name)
+{
+    // FNV-1a, the same spread as PlayerNameMapHolder
+    uint32 hash = 2166136261u;
+    for (std::string::const_iterator itr = name.begin(); itr != name.end(); ++itr)
+        hash = (hash ^ uint8(*itr)) * 16777619u;
+
+    return m_charNameShards[hash % CharNameShardCount];
 }
 
-void InfoMgr::_RemoveName(std::string name)
+size_t InfoMgr::_GetNameCount() const
 {
-    CharInfoNameItr itr = m_charInfosName.find(name);
-    if (itr != m_charInfosName.end())
-        m_charInfosName.erase(itr);
+    size_t count = 0;
+    for (uint32 i = 0; i < CharNameShardCount; ++i)
+        count += m_charNameShards[i].names.size();
+    return count;
 }
 
 void InfoMgr::IncreaseAccountCharCount(uint32 id)
@@ -634,12 +801,15 @@ void InfoMgr::UnloadAll()
 {
     sLog->outInfo(LOG_FILTER_SERVER_LOADING, "InfoMgr::UnloadAll()");
 
-    for (CharInfoItr charItr = m_charInfos.begin(); charItr != m_charInfos.end(); ++charItr)
+    for (std::vector<CharSlot*>::iterator itr = m_charChunks.begin(); itr != m_charChunks.end(); ++itr)
     {
-        delete charItr->second;
+        delete[] *itr;
+        *itr = NULL;
     }
-    m_charInfos.clear();
-    m_charInfosName.clear();
+    m_charChunkCount = 0;
+    m_charCount = 0;
+    for (uint32 i = 0; i < CharNameShardCount; ++i)
+        m_charNameShards[i].names.clear();
 
     /*for (PetsToOwnerMapItr itr = petsToOwner.begin(); itr != petsToOwner.end(); ++itr)
     {
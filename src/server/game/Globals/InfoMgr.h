@@ -4,6 +4,8 @@
 #include "Common.h"
 #include "ArenaTeam.h"
 #include <ace/Singleton.h>
+#include <ace/Atomic_Op.h>
+#include <ace/RW_Thread_Mutex.h>
 #include "ObjectMgr.h"
 
 #define MAX_INFOCHAR_NAME_LENGTH (MAX_CHARTER_NAME * 2 + 1) // should be MAX_CHARACTER_NAME + 1 but i saw longer name in db... idk
@@ -26,8 +28,13 @@ struct InfoCharEntry
 
 class InfoMgr
 {
+    friend class ACE_Singleton<InfoMgr, ACE_Null_Mutex>;
+    friend class InfoCharLoader;
+
+    InfoMgr();
+    ~InfoMgr();
+
 public:
-    //~InfoMgr();
     // Misc
     void Initialize();
     void UnloadAll();
@@ -42,7 +49,8 @@ public:
     void RemoveCharInfo(uint32 guid);
     bool GetCharInfo(uint32 guid, InfoCharEntry &info);
     bool GetCharInfo(std::string name, InfoCharEntry &info);
-    uint32 GetCharCount() { return m_charInfos.size(); }
+    uint32 GetCharCount() const { return uint32(m_charCount.value()); }
+    size_t GetMemoryUsage() const;
 
     // Accounts
     void IncreaseAccountCharCount(uint32 id);
@@ -56,16 +64,53 @@ public:
     void DeleteAllPetsFromOwner(uint32 ownerGuid);*/
 
 private:
-    // Characters
-    void _RemoveName(std::string name);
-    void _AddName(std::string name, InfoCharEntry *info);
-    typedef std::map<std::string, InfoCharEntry*> CharInfoNameMap;
-    typedef std::map<uint32, InfoCharEntry*> CharInfoMap;
+    // Characters are stored by guid in chunks that are never moved or freed before UnloadAll.
+    // Every slot has a sequence number that is odd while the slot is written, readers copy
+    // the entry and retry if the sequence changed meanwhile, so they never take a lock.
+    struct CharSlot
+    {
+        CharSlot() : Sequence(0) { memset(&Info, 0, sizeof(Info)); }
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> Sequence;
+        InfoCharEntry Info;                                 // Guid is 0 while unused
+    };
+
+    static uint32 const CharChunkBits = 12;
+    static uint32 const CharChunkSize = 1 << CharChunkBits;
+    static uint32 const MaxCharChunks = uint32(0x100000000ULL >> CharChunkBits);
+
+    CharSlot* _FindSlot(uint32 guid) const;
+    CharSlot* _CreateSlot(uint32 guid);                     // writers only
+    void _ReserveSlots(uint32 maxGuid);
+    static bool _ReadSlot(CharSlot& slot, InfoCharEntry &info);
+    static void _BeginWrite(CharSlot& slot) { ++slot.Sequence; }
+    static void _EndWrite(CharSlot& slot) { ++slot.Sequence; }
+    void _SetCharBase(CharSlot& slot, uint32 guid, std::string const& name, uint8 gender, uint8 race, uint8 cclass, uint32 account, uint8 level, uint16 zone);
+    void _LoadCharBase(uint32 beginGuid, uint32 endGuid);
+
+    // names are kept normalized (see normalizePlayerName) so lookups ignore case. They are
+    // spread over shards by hash like the online names, see PlayerNameMapHolder
+    void _RemoveName(std::string name, uint32 guid);
+    void _AddName(std::string name, uint32 guid);
+    typedef UNORDERED_MAP<std::string, uint32> CharInfoNameMap;
     typedef CharInfoNameMap::iterator CharInfoNameItr;
-    typedef CharInfoMap::iterator CharInfoItr;
-    CharInfoNameMap m_charInfosName;
-    CharInfoMap m_charInfos;
-    ACE_Thread_Mutex m_charMutex;
+
+    static uint32 const CharNameShardCount = 16;
+
+    struct CharNameShard
+    {
+        ACE_RW_Thread_Mutex lock;
+        CharInfoNameMap names;
+    };
+
+    CharNameShard& _GetNameShard(std::string const& name);
+    size_t _GetNameCount() const;
+
+    std::vector<CharSlot*> m_charChunks;                    // MaxCharChunks entries, allocated on demand
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> m_charChunkCount;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> m_charCount;
+    ACE_Thread_Mutex m_charMutex;                           // serializes writers
+    CharNameShard m_charNameShards[CharNameShardCount];
 
     // Accounts
     void SetAccountCharCount(uint32 id, uint8 count);
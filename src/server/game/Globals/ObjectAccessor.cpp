@@ -17,6 +17,7 @@
  */
 
 #include "ObjectAccessor.h"
+#include "AreaTrigger.h"
 #include "CellImpl.h"
 #include "Corpse.h"
 #include "Creature.h"
@@ -137,6 +138,17 @@ Unit* ObjectAccessor::GetUnit(WorldObject const& u, uint64 guid)
     return GetObjectInMap(guid, u.GetMap(), (Unit*)NULL);
 }
 
+Unit* ObjectAccessor::GetUnitInOrOutOfWorld(WorldObject const& u, uint64 guid)
+{
+    if (IS_PLAYER_GUID(guid))
+        return GetObjectInOrOutOfWorld(guid, (Player*)NULL);
+
+    if (IS_PET_GUID(guid))
+        return GetObjectInOrOutOfWorld(guid, (Pet*)NULL);
+
+    return GetUnit(u, guid);
+}
+
 Creature* ObjectAccessor::GetCreature(WorldObject const& u, uint64 guid)
 {
     return GetObjectInMap(guid, u.GetMap(), (Creature*)NULL);
@@ -163,6 +175,47 @@ Creature* ObjectAccessor::GetCreatureOrPetOrVehicle(WorldObject const& u, uint64
     return NULL;
 }
 
+Creature* ObjectAccessor::GetObjectInMap(uint64 guid, Map* map, Creature* /*typeSpecifier*/)
+{
+    ASSERT(map);
+    return map->GetCreature(guid);
+}
+
+GameObject* ObjectAccessor::GetObjectInMap(uint64 guid, Map* map, GameObject* /*typeSpecifier*/)
+{
+    ASSERT(map);
+    return map->GetGameObject(guid);
+}
+
+DynamicObject* ObjectAccessor::GetObjectInMap(uint64 guid, Map* map, DynamicObject* /*typeSpecifier*/)
+{
+    ASSERT(map);
+    return map->GetDynamicObject(guid);
+}
+
+Corpse* ObjectAccessor::GetObjectInMap(uint64 guid, Map* map, Corpse* /*typeSpecifier*/)
+{
+    ASSERT(map);
+    return map->GetCorpse(guid);
+}
+
+AreaTrigger* ObjectAccessor::GetObjectInMap(uint64 guid, Map* map, AreaTrigger* /*typeSpecifier*/)
+{
+    ASSERT(map);
+    return map->GetAreaTrigger(guid);
+}
+
+Unit* ObjectAccessor::GetObjectInMap(uint64 guid, Map* map, Unit* /*typeSpecifier*/)
+{
+    if (IS_PLAYER_GUID(guid))
+        return GetObjectInMap(guid, map, (Player*)NULL);
+
+    if (IS_PET_GUID(guid))
+        return GetObjectInMap(guid, map, (Pet*)NULL);
+
+    return GetObjectInMap(guid, map, (Creature*)NULL);
+}
+
 Pet* ObjectAccessor::FindPet(uint64 guid)
 {
     return GetObjectInWorld(guid, (Pet*)NULL);
@@ -173,28 +226,131 @@ Player* ObjectAccessor::FindPlayer(uint64 guid)
     return GetObjectInWorld(guid, (Player*)NULL);
 }
 
-Unit* ObjectAccessor::FindUnit(uint64 guid)
+Creature* ObjectAccessor::FindSpawnedCreature(uint64 guid)
 {
-    return GetObjectInWorld(guid, (Unit*)NULL);
+    std::vector<Creature*> creatures;
+    FindSpawnedCreatures(guid, creatures);
+    return creatures.empty() ? NULL : creatures.front();
 }
 
-Player* ObjectAccessor::FindPlayerByName(std::string const& name)
+GameObject* ObjectAccessor::FindSpawnedGameObject(uint64 guid)
 {
-    TRINITY_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock());
-    std::string nameStr = name;
-    std::transform(nameStr.begin(), nameStr.end(), nameStr.begin(), ::tolower);
-    HashMapHolder<Player>::MapType const& m = GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
-    {
-        if (!iter->second->IsInWorld())
-            continue;
-        std::string currentName = iter->second->GetName();
-        std::transform(currentName.begin(), currentName.end(), currentName.begin(), ::tolower);
-        if (nameStr.compare(currentName) == 0)
-            return iter->second;
-    }
+    std::vector<GameObject*> gameobjects;
+    FindSpawnedGameObjects(guid, gameobjects);
+    return gameobjects.empty() ? NULL : gameobjects.front();
+}
 
-    return NULL;
+void ObjectAccessor::FindSpawnedCreatures(uint64 guid, std::vector<Creature*>& creatures)
+{
+    CreatureData const* data = sObjectMgr->GetCreatureData(GUID_LOPART(guid));
+    if (!data)
+        return;
+
+    Map* map = sMapMgr->FindBaseMap(data->mapid);
+    if (!map)
+        return;
+
+    if (Creature* creature = map->GetCreature(guid))
+        creatures.push_back(creature);
+
+    if (!map->Instanceable())
+        return;
+
+    // every instance spawns its own copy with the same guid
+    MapInstanced::InstancedMaps& instances = ((MapInstanced*)map)->GetInstancedMaps();
+    for (MapInstanced::InstancedMaps::const_iterator itr = instances.begin(); itr != instances.end(); ++itr)
+        if (Creature* creature = itr->second->GetCreature(guid))
+            creatures.push_back(creature);
+}
+
+void ObjectAccessor::FindSpawnedGameObjects(uint64 guid, std::vector<GameObject*>& gameobjects)
+{
+    GameObjectData const* data = sObjectMgr->GetGOData(GUID_LOPART(guid));
+    if (!data)
+        return;
+
+    Map* map = sMapMgr->FindBaseMap(data->mapid);
+    if (!map)
+        return;
+
+    if (GameObject* gameobject = map->GetGameObject(guid))
+        gameobjects.push_back(gameobject);
+
+    if (!map->Instanceable())
+        return;
+
+    MapInstanced::InstancedMaps& instances = ((MapInstanced*)map)->GetInstancedMaps();
+    for (MapInstanced::InstancedMaps::const_iterator itr = instances.begin(); itr != instances.end(); ++itr)
+        if (GameObject* gameobject = itr->second->GetGameObject(guid))
+            gameobjects.push_back(gameobject);
+}
+
+void ObjectAccessor::AddObject(Player* object)
+{
+    HashMapHolder<Player>::Insert(object);
+    PlayerNameMapHolder::Insert(object);
+}
+
+void ObjectAccessor::RemoveObject(Player* object)
+{
+    HashMapHolder<Player>::Remove(object);
+    PlayerNameMapHolder::Remove(object);
+}
+
+void ObjectAccessor::AddObject(Creature* object)
+{
+    object->GetMap()->AddToObjectStore(object);
+}
+
+void ObjectAccessor::AddObject(GameObject* object)
+{
+    object->GetMap()->AddToObjectStore(object);
+}
+
+void ObjectAccessor::AddObject(DynamicObject* object)
+{
+    object->GetMap()->AddToObjectStore(object);
+}
+
+void ObjectAccessor::AddObject(Corpse* object)
+{
+    object->GetMap()->AddToObjectStore(object);
+}
+
+void ObjectAccessor::AddObject(AreaTrigger* object)
+{
+    object->GetMap()->AddToObjectStore(object);
+}
+
+void ObjectAccessor::RemoveObject(Creature* object)
+{
+    object->GetMap()->RemoveFromObjectStore(object);
+}
+
+void ObjectAccessor::RemoveObject(GameObject* object)
+{
+    object->GetMap()->RemoveFromObjectStore(object);
+}
+
+void ObjectAccessor::RemoveObject(DynamicObject* object)
+{
+    object->GetMap()->RemoveFromObjectStore(object);
+}
+
+void ObjectAccessor::RemoveObject(Corpse* object)
+{
+    object->GetMap()->RemoveFromObjectStore(object);
+}
+
+void ObjectAccessor::RemoveObject(AreaTrigger* object)
+{
+    object->GetMap()->RemoveFromObjectStore(object);
+}
+
+Player* ObjectAccessor::FindPlayerByName(std::string const& name)
+{
+    Player* player = PlayerNameMapHolder::Find(name);
+    return player && player->IsInWorld() ? player : NULL;
 }
 
 void ObjectAccessor::SaveAllPlayers()
@@ -404,6 +560,54 @@ void ObjectAccessor::UnloadAll()
     }
 }
 
+PlayerNameMapHolder::Shard PlayerNameMapHolder::_shards[PlayerNameMapHolder::ShardCount];
+
+PlayerNameMapHolder::Shard& PlayerNameMapHolder::GetShard(std::string const& key)
+{
+    // FNV-1a, spreads names of the same length and first letter as well
+    uint32 hash = 2166136261u;
+    for (std::string::const_iterator itr = key.begin(); itr != key.end(); ++itr)
+        hash = (hash ^ uint8(*itr)) * 16777619u;
+
+    return _shards[hash % ShardCount];
+}
+
+void PlayerNameMapHolder::Insert(Player* player)
+{
+    std::string key = player->GetName();
+    if (!normalizePlayerName(key))
+        return;
+
+    Shard& shard = GetShard(key);
+    TRINITY_WRITE_GUARD(ACE_RW_Thread_Mutex, shard.lock);
+    shard.players[key] = player;
+}
+
+void PlayerNameMapHolder::Remove(Player* player)
+{
+    std::string key = player->GetName();
+    if (!normalizePlayerName(key))
+        return;
+
+    Shard& shard = GetShard(key);
+    TRINITY_WRITE_GUARD(ACE_RW_Thread_Mutex, shard.lock);
+    Shard::MapType::iterator itr = shard.players.find(key);
+    if (itr != shard.players.end() && itr->second == player)
+        shard.players.erase(itr);
+}
+
+Player* PlayerNameMapHolder::Find(std::string const& name)
+{
+    std::string key = name;
+    if (!normalizePlayerName(key))
+        return NULL;
+
+    Shard& shard = GetShard(key);
+    TRINITY_READ_GUARD(ACE_RW_Thread_Mutex, shard.lock);
+    Shard::MapType::const_iterator itr = shard.players.find(key);
+    return itr != shard.players.end() ? itr->second : NULL;
+}
+
 /// Define the static members of HashMapHolder
 
 template <class T> UNORDERED_MAP< uint64, T* > HashMapHolder<T>::m_objectMap;
@@ -413,14 +617,6 @@ template <class T> typename HashMapHolder<T>::LockType HashMapHolder<T>::i_lock;
 
 template class HashMapHolder<Player>;
 template class HashMapHolder<Pet>;
-template class HashMapHolder<GameObject>;
-template class HashMapHolder<DynamicObject>;
-template class HashMapHolder<Creature>;
-template class HashMapHolder<Corpse>;
 
 template Player* ObjectAccessor::GetObjectInWorld<Player>(uint32 mapid, float x, float y, uint64 guid, Player* /*fake*/);
 template Pet* ObjectAccessor::GetObjectInWorld<Pet>(uint32 mapid, float x, float y, uint64 guid, Pet* /*fake*/);
-template Creature* ObjectAccessor::GetObjectInWorld<Creature>(uint32 mapid, float x, float y, uint64 guid, Creature* /*fake*/);
-template Corpse* ObjectAccessor::GetObjectInWorld<Corpse>(uint32 mapid, float x, float y, uint64 guid, Corpse* /*fake*/);
-template GameObject* ObjectAccessor::GetObjectInWorld<GameObject>(uint32 mapid, float x, float y, uint64 guid, GameObject* /*fake*/);
-template DynamicObject* ObjectAccessor::GetObjectInWorld<DynamicObject>(uint32 mapid, float x, float y, uint64 guid, DynamicObject* /*fake*/);
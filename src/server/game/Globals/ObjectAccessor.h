@@ -80,6 +80,33 @@ class HashMapHolder
         static MapType m_objectMap;
 };
 
+// online players by normalized name (see normalizePlayerName), split into shards with their
+// own lock so lookups from different threads rarely wait for each other
+class PlayerNameMapHolder
+{
+    public:
+        static void Insert(Player* player);
+        static void Remove(Player* player);
+        static Player* Find(std::string const& name);
+
+    private:
+        PlayerNameMapHolder() {}
+
+        static uint32 const ShardCount = 16;
+
+        struct Shard
+        {
+            typedef UNORDERED_MAP<std::string, Player*> MapType;
+
+            ACE_RW_Thread_Mutex lock;
+            MapType players;
+        };
+
+        static Shard& GetShard(std::string const& key);
+
+        static Shard _shards[ShardCount];
+};
+
 class ObjectAccessor
 {
     friend class ACE_Singleton<ObjectAccessor, ACE_Null_Mutex>;
@@ -92,22 +119,12 @@ class ObjectAccessor
     public:
         // TODO: override these template functions for each holder type and add assertions
 
+        // only players and pets are known to the whole world, everything else is looked up in its map
         template<class T> static T* GetObjectInOrOutOfWorld(uint64 guid, T* /*typeSpecifier*/)
         {
             return HashMapHolder<T>::Find(guid);
         }
 
-        static Unit* GetObjectInOrOutOfWorld(uint64 guid, Unit* /*typeSpecifier*/)
-        {
-            if (IS_PLAYER_GUID(guid))
-                return (Unit*)GetObjectInOrOutOfWorld(guid, (Player*)NULL);
-
-            if (IS_PET_GUID(guid))
-                return (Unit*)GetObjectInOrOutOfWorld(guid, (Pet*)NULL);
-
-            return (Unit*)GetObjectInOrOutOfWorld(guid, (Creature*)NULL);
-        }
-
         // returns object if is in world
         template<class T> static T* GetObjectInWorld(uint64 guid, T* /*typeSpecifier*/)
         {
@@ -117,17 +134,6 @@ class ObjectAccessor
         // Player may be not in world while in ObjectAccessor
         static Player* GetObjectInWorld(uint64 guid, Player* /*typeSpecifier*/);
 
-        static Unit* GetObjectInWorld(uint64 guid, Unit* /*typeSpecifier*/)
-        {
-            if (IS_PLAYER_GUID(guid))
-                return (Unit*)GetObjectInWorld(guid, (Player*)NULL);
-
-            if (IS_PET_GUID(guid))
-                return (Unit*)GetObjectInWorld(guid, (Pet*)NULL);
-
-            return (Unit*)GetObjectInWorld(guid, (Creature*)NULL);
-        }
-
         // returns object if is in map
         template<class T> static T* GetObjectInMap(uint64 guid, Map* map, T* /*typeSpecifier*/)
         {
@@ -138,6 +144,14 @@ class ObjectAccessor
             return NULL;
         }
 
+        // objects stored by their map, see Map::AddToObjectStore
+        static Creature* GetObjectInMap(uint64 guid, Map* map, Creature* /*typeSpecifier*/);
+        static GameObject* GetObjectInMap(uint64 guid, Map* map, GameObject* /*typeSpecifier*/);
+        static DynamicObject* GetObjectInMap(uint64 guid, Map* map, DynamicObject* /*typeSpecifier*/);
+        static Corpse* GetObjectInMap(uint64 guid, Map* map, Corpse* /*typeSpecifier*/);
+        static AreaTrigger* GetObjectInMap(uint64 guid, Map* map, AreaTrigger* /*typeSpecifier*/);
+        static Unit* GetObjectInMap(uint64 guid, Map* map, Unit* /*typeSpecifier*/);
+
         template<class T> static T* GetObjectInWorld(uint32 mapid, float x, float y, uint64 guid, T* /*fake*/)
         {
             T* obj = HashMapHolder<T>::Find(guid);
@@ -175,6 +189,8 @@ class ObjectAccessor
         static DynamicObject* GetDynamicObject(WorldObject const& u, uint64 guid);
         static AreaTrigger* GetAreaTrigger(WorldObject const& u, uint64 guid);
         static Unit* GetUnit(WorldObject const&, uint64 guid);
+        // players and pets are found on any map and out of world, other units only on the map of u
+        static Unit* GetUnitInOrOutOfWorld(WorldObject const& u, uint64 guid);
         static Creature* GetCreature(WorldObject const& u, uint64 guid);
         static Pet* GetPet(WorldObject const&, uint64 guid);
         static Player* GetPlayer(WorldObject const&, uint64 guid);
@@ -184,8 +200,14 @@ class ObjectAccessor
         // ACCESS LIKE THAT IS NOT THREAD SAFE
         static Pet* FindPet(uint64);
         static Player* FindPlayer(uint64);
-        static Creature* FindCreature(uint64);
-        static Unit* FindUnit(uint64);
+
+        // creatures and gameobjects spawned from the database, found through the map of their spawn data
+        // can only be used while the maps are not updated. The Find*s variants return the copies of all
+        // instances, the others only the first one found.
+        static Creature* FindSpawnedCreature(uint64 guid);
+        static GameObject* FindSpawnedGameObject(uint64 guid);
+        static void FindSpawnedCreatures(uint64 guid, std::vector<Creature*>& creatures);
+        static void FindSpawnedGameObjects(uint64 guid, std::vector<GameObject*>& gameobjects);
         static Player* FindPlayerByName(std::string const& name);
 
         // when using this, you must use the hashmapholder's lock
@@ -194,18 +216,6 @@ class ObjectAccessor
             return HashMapHolder<Player>::GetContainer();
         }
 
-        // when using this, you must use the hashmapholder's lock
-        static HashMapHolder<Creature>::MapType const& GetCreatures()
-        {
-            return HashMapHolder<Creature>::GetContainer();
-        }
-
-        // when using this, you must use the hashmapholder's lock
-        static HashMapHolder<GameObject>::MapType const& GetGameObjects()
-        {
-            return HashMapHolder<GameObject>::GetContainer();
-        }
-
         template<class T> static void AddObject(T* object)
         {
             HashMapHolder<T>::Insert(object);
@@ -216,6 +226,22 @@ class ObjectAccessor
             HashMapHolder<T>::Remove(object);
         }
 
+        // also registered by name
+        static void AddObject(Player* object);
+        static void RemoveObject(Player* object);
+
+        // registered in the map of the object instead of a global container
+        static void AddObject(Creature* object);
+        static void AddObject(GameObject* object);
+        static void AddObject(DynamicObject* object);
+        static void AddObject(Corpse* object);
+        static void AddObject(AreaTrigger* object);
+        static void RemoveObject(Creature* object);
+        static void RemoveObject(GameObject* object);
+        static void RemoveObject(DynamicObject* object);
+        static void RemoveObject(Corpse* object);
+        static void RemoveObject(AreaTrigger* object);
+
         static void SaveAllPlayers();
 
         //non-static functions
@@ -5326,132 +5326,288 @@ void ObjectMgr::LoadNpcTextLocales()
     sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> Loaded %lu NpcText locale strings in %u ms", (unsigned long)_npcTextLocaleStore.size(), GetMSTimeDiffToNow(oldMSTime));
 }
 
-//not very fast function but it is called only once a day, or on starting-up
+//not very fast function, runs to completion only on starting-up, once a day the work is spread over the world updates
 void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
 {
-    uint32 oldMSTime = getMSTime();
+    if (_oldMails.Running)
+        return;                                             // previous run not finished yet
 
     time_t curTime = time(NULL);
     tm* lt = localtime(&curTime);
-    uint64 basetime(curTime);
     sLog->outInfo(LOG_FILTER_GENERAL, "Returning mails current time: hour: %d, minute: %d, second: %d ", lt->tm_hour, lt->tm_min, lt->tm_sec);
 
+    _oldMails = OldMailsExpiry();
+    _oldMails.Running = true;
+    _oldMails.ServerUp = serverUp;
+    _oldMails.BaseTime = uint64(curTime);
+    _oldMails.StartTime = getMSTime();
+
+    if (serverUp)
+    {
+        _oldMails.MailsResult = CharacterDatabase.AsyncQuery(_GetOldMailsStatement(0));
+        _oldMails.WaitingMails = true;
+        return;
+    }
+
     // Delete all old mails without item and without body immediately, if starting server
-    if (!serverUp)
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_EMPTY_EXPIRED_MAIL);
+    stmt->setUInt64(0, _oldMails.BaseTime);
+    CharacterDatabase.Execute(stmt);
+
+    do
+    {
+        _LoadOldMailsPage(CharacterDatabase.Query(_GetOldMailsStatement(_oldMails.LastMailId)));
+        if (_oldMails.Page.empty())
+            break;
+
+        _LoadOldMailItems(CharacterDatabase.Query(_GetOldMailItemsStatement()));
+        _ProcessOldMails(0);
+    }
+    while (!_oldMails.LastPage);
+
+    _FinishOldMails();
+}
+
+void ObjectMgr::UpdateOldMails()
+{
+    if (!_oldMails.Running)
+        return;
+
+    if (_oldMails.Position >= _oldMails.Page.size() && !_oldMails.WaitingItems)
+    {
+        if (!_oldMails.WaitingMails)
+        {
+            _FinishOldMails();
+            return;
+        }
+
+        if (!_oldMails.MailsResult.ready())
+            return;
+
+        PreparedQueryResult result;
+        _oldMails.MailsResult.get(result);
+        _oldMails.MailsResult.cancel();
+        _oldMails.WaitingMails = false;
+
+        _LoadOldMailsPage(result);
+        if (_oldMails.Page.empty())
+        {
+            _FinishOldMails();
+            return;
+        }
+
+        _oldMails.ItemsResult = CharacterDatabase.AsyncQuery(_GetOldMailItemsStatement());
+        _oldMails.WaitingItems = true;
+
+        // read the next page while this one is handled
+        if (!_oldMails.LastPage)
+        {
+            _oldMails.MailsResult = CharacterDatabase.AsyncQuery(_GetOldMailsStatement(_oldMails.LastMailId));
+            _oldMails.WaitingMails = true;
+        }
+    }
+
+    if (_oldMails.WaitingItems)
     {
-        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_EMPTY_EXPIRED_MAIL);
-        stmt->setUInt64(0, basetime);
-        CharacterDatabase.Execute(stmt);
+        if (!_oldMails.ItemsResult.ready())
+            return;
+
+        PreparedQueryResult result;
+        _oldMails.ItemsResult.get(result);
+        _oldMails.ItemsResult.cancel();
+        _oldMails.WaitingItems = false;
+
+        _LoadOldMailItems(result);
     }
+
+    _ProcessOldMails(MAIL_EXPIRE_PER_UPDATE);
+}
+
+PreparedStatement* ObjectMgr::_GetOldMailsStatement(uint32 lastMailId) const
+{
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAIL);
-    stmt->setUInt64(0, basetime);
-    PreparedQueryResult result = CharacterDatabase.Query(stmt);
+    stmt->setUInt64(0, _oldMails.BaseTime);
+    stmt->setUInt32(1, lastMailId);
+    stmt->setUInt32(2, MAIL_EXPIRE_PAGE_SIZE);
+    return stmt;
+}
+
+PreparedStatement* ObjectMgr::_GetOldMailItemsStatement() const
+{
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAIL_ITEMS);
+    stmt->setUInt32(0, uint32(_oldMails.BaseTime));
+    stmt->setUInt32(1, _oldMails.Page.front().messageID);
+    stmt->setUInt32(2, _oldMails.Page.back().messageID);
+    return stmt;
+}
+
+void ObjectMgr::_LoadOldMailsPage(PreparedQueryResult result)
+{
+    _oldMails.Page.clear();
+    _oldMails.Position = 0;
+
     if (!result)
     {
-        sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> No expired mails found.");
-        return;                                             // any mails need to be returned or deleted
+        _oldMails.LastPage = true;
+        return;
     }
 
-    std::map<uint32 /*messageId*/, MailItemInfoVec> itemsCache;
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_EXPIRED_MAIL_ITEMS);
-    stmt->setUInt32(0, (uint32)basetime);
-    if (PreparedQueryResult items = CharacterDatabase.Query(stmt))
+    _oldMails.Page.reserve(size_t(result->GetRowCount()));
+    do
     {
-        MailItemInfo item;
-        do
-        {
-            Field* fields = items->Fetch();
-            item.item_guid = fields[0].GetUInt32();
-            item.item_template = fields[1].GetUInt32();
-            uint32 mailId = fields[2].GetUInt32();
-            itemsCache[mailId].push_back(item);
-        } while (items->NextRow());
+        Field* fields = result->Fetch();
+        Mail m;
+        m.messageID      = fields[0].GetUInt32();
+        m.messageType    = fields[1].GetUInt8();
+        m.stationery     = 0;
+        m.sender         = fields[2].GetUInt32();
+        m.receiver       = fields[3].GetUInt32();
+        m.expire_time    = time_t(fields[4].GetUInt32());
+        m.deliver_time   = 0;
+        m.money          = 0;
+        m.COD            = fields[5].GetUInt64();
+        m.checked        = fields[6].GetUInt8();
+        m.mailTemplateId = fields[7].GetInt16();
+        m.state          = MAIL_STATE_UNCHANGED;
+        _oldMails.Page.push_back(m);
     }
+    while (result->NextRow());
+
+    _oldMails.LastMailId = _oldMails.Page.back().messageID;
+    _oldMails.LastPage = _oldMails.Page.size() < MAIL_EXPIRE_PAGE_SIZE;
+}
+
+void ObjectMgr::_LoadOldMailItems(PreparedQueryResult result)
+{
+    if (!result)
+        return;
 
-    uint32 deletedCount = 0;
-    uint32 returnedCount = 0;
+    std::map<uint32 /*messageId*/, MailItemInfoVec> itemsCache;
+    MailItemInfo item;
     do
     {
         Field* fields = result->Fetch();
-        Mail* m = new Mail;
-        m->messageID      = fields[0].GetUInt32();
-        m->messageType    = fields[1].GetUInt8();
-        m->sender         = fields[2].GetUInt32();
-        m->receiver       = fields[3].GetUInt32();
-        bool has_items    = fields[4].GetBool();
-        m->expire_time    = time_t(fields[5].GetUInt32());
-        m->deliver_time   = 0;
-        m->COD            = fields[6].GetUInt64();
-        m->checked        = fields[7].GetUInt8();
-        m->mailTemplateId = fields[8].GetInt16();
-
-        Player* player = NULL;
-        if (serverUp)
-            player = ObjectAccessor::FindPlayer((uint64)m->receiver);
-
-        if (player && player->m_mailsLoaded)
-        {                                                   // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
-            // his in mailbox and he has already listed his mails)
-            delete m;
-            continue;
+        item.item_guid = fields[0].GetUInt32();
+        item.item_template = fields[1].GetUInt32();
+        uint32 mailId = fields[2].GetUInt32();
+        itemsCache[mailId].push_back(item);
+    }
+    while (result->NextRow());
+
+    for (std::vector<Mail>::iterator itr = _oldMails.Page.begin(); itr != _oldMails.Page.end(); ++itr)
+    {
+        std::map<uint32, MailItemInfoVec>::iterator items = itemsCache.find(itr->messageID);
+        if (items != itemsCache.end())
+            itr->items.swap(items->second);
+    }
+}
+
+void ObjectMgr::_ProcessOldMails(uint32 limit)
+{
+    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    uint32 batched = 0;
+    uint32 processed = 0;
+
+    while (_oldMails.Position < _oldMails.Page.size() && (!limit || processed < limit))
+    {
+        Mail const& m = _oldMails.Page[_oldMails.Position++];
+        ++processed;
+
+        // a loaded mailbox of an online player is handled on the player's map thread, the mails of
+        // players who did not open theirs yet are read from the database at load and expire here
+        if (_oldMails.ServerUp)
+        {
+            Player* player = ObjectAccessor::FindPlayer((uint64)m.receiver);
+            if (player && player->IsMailsLoaded())
+            {
+                if (_oldMails.DeferredReceivers.insert(m.receiver).second)
+                    player->m_Events.AddEvent(new MailExpiryEvent(player), player->m_Events.CalculateTime(0));
+
+                ++_oldMails.DeferredCount;
+                continue;
+            }
         }
 
-        // Delete or return mail
-        if (has_items)
+        if (ReturnOrDeleteOldMail(trans, m, _oldMails.BaseTime))
+            ++_oldMails.ReturnedCount;
+        else
+            ++_oldMails.DeletedCount;
+
+        if (++batched >= MAIL_EXPIRE_BATCH_SIZE)
         {
-            // read items from cache
-            m->items.swap(itemsCache[m->messageID]);
+            CharacterDatabase.CommitTransaction(trans);
+            trans = CharacterDatabase.BeginTransaction();
+            batched = 0;
+        }
+    }
+
+    if (batched)
+        CharacterDatabase.CommitTransaction(trans);
+}
+
+void ObjectMgr::_FinishOldMails()
+{
+    if (!_oldMails.DeletedCount && !_oldMails.ReturnedCount && !_oldMails.DeferredCount)
+        sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> No expired mails found.");
+    else
+        sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> Processed %u expired mails: %u deleted, %u returned and %u left to online players in %u ms",
+            _oldMails.DeletedCount + _oldMails.ReturnedCount + _oldMails.DeferredCount, _oldMails.DeletedCount, _oldMails.ReturnedCount,
+            _oldMails.DeferredCount, GetMSTimeDiffToNow(_oldMails.StartTime));
+
+    _oldMails = OldMailsExpiry();
+}
 
-            // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
-            if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
+// Returns the mail to its sender if it holds items, deletes it otherwise. Returns true if the mail was returned.
+bool ObjectMgr::ReturnOrDeleteOldMail(SQLTransaction& trans, Mail const& mail, uint64 basetime)
+{
+    PreparedStatement* stmt;
+
+    // Delete or return mail
+    if (mail.HasItems())
+    {
+        // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
+        if (mail.messageType != MAIL_NORMAL || (mail.checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
+        {
+            // mail open and then not returned
+            for (MailItemInfoVec::const_iterator itr = mail.items.begin(); itr != mail.items.end(); ++itr)
             {
-                // mail open and then not returned
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                {
-                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ITEM_INSTANCE);
-                    stmt->setUInt32(0, itr2->item_guid);
-                    CharacterDatabase.Execute(stmt);
-                }
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ITEM_INSTANCE);
+                stmt->setUInt32(0, itr->item_guid);
+                trans->Append(stmt);
             }
-            else
-            {
-                // Mail will be returned
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_RETURNED);
-                stmt->setUInt32(0, m->receiver);
-                stmt->setUInt32(1, m->sender);
-                stmt->setUInt32(2, basetime + 30 * DAY);
-                stmt->setUInt32(3, basetime);
-                stmt->setUInt8 (4, uint8(MAIL_CHECK_MASK_RETURNED));
-                stmt->setUInt32(5, m->messageID);
-                CharacterDatabase.Execute(stmt);
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                {
-                    // Update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
-                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_ITEM_RECEIVER);
-                    stmt->setUInt32(0, m->sender);
-                    stmt->setUInt32(1, itr2->item_guid);
-                    CharacterDatabase.Execute(stmt);
-
-                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ITEM_OWNER);
-                    stmt->setUInt32(0, m->sender);
-                    stmt->setUInt32(1, itr2->item_guid);
-                    CharacterDatabase.Execute(stmt);
-                }
-                delete m;
-                ++returnedCount;
-                continue;
+        }
+        else
+        {
+            // Mail will be returned
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_RETURNED);
+            stmt->setUInt32(0, mail.receiver);
+            stmt->setUInt32(1, mail.sender);
+            stmt->setUInt32(2, basetime + 30 * DAY);
+            stmt->setUInt32(3, basetime);
+            stmt->setUInt8 (4, uint8(MAIL_CHECK_MASK_RETURNED));
+            stmt->setUInt32(5, mail.messageID);
+            trans->Append(stmt);
+            for (MailItemInfoVec::const_iterator itr = mail.items.begin(); itr != mail.items.end(); ++itr)
+            {
+                // Update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MAIL_ITEM_RECEIVER);
+                stmt->setUInt32(0, mail.sender);
+                stmt->setUInt32(1, itr->item_guid);
+                trans->Append(stmt);
+
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ITEM_OWNER);
+                stmt->setUInt32(0, mail.sender);
+                stmt->setUInt32(1, itr->item_guid);
+                trans->Append(stmt);
             }
+            return true;
         }
-
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_MAIL_BY_ID);
-        stmt->setUInt32(0, m->messageID);
-        CharacterDatabase.Execute(stmt);
-        delete m;
-        ++deletedCount;
     }
-    while (result->NextRow());
 
-    sLog->outInfo(LOG_FILTER_SERVER_LOADING, ">> Processed %u expired mails: %u deleted and %u returned in %u ms", deletedCount + returnedCount, deletedCount, returnedCount, GetMSTimeDiffToNow(oldMSTime));
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_MAIL_BY_ID);
+    stmt->setUInt32(0, mail.messageID);
+    trans->Append(stmt);
+    return false;
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
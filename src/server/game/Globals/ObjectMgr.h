@@ -666,6 +666,11 @@ struct HotfixInfo
 
 typedef std::vector<HotfixInfo> HotfixData;
 
+// expired mails read from the database at once, handled in one transaction, and by one world update
+#define MAIL_EXPIRE_PAGE_SIZE  1000
+#define MAIL_EXPIRE_BATCH_SIZE 50
+#define MAIL_EXPIRE_PER_UPDATE 500
+
 class PlayerDumpReader;
 
 class ObjectMgr
@@ -1005,7 +1010,11 @@ class ObjectMgr
         ResearchSiteInfo const* GetResearchSiteInfo(uint32 siteEntry) const;
         std::list<uint32> GetResearchSiteList(uint32 mapId, uint32 skill, uint8 level) const;
 
+        // Runs to completion at startup, while the server is up the mails are read asynchronously
+        // page by page and handled by UpdateOldMails in the following world updates
         void ReturnOrDeleteOldMails(bool serverUp);
+        void UpdateOldMails();
+        bool ReturnOrDeleteOldMail(SQLTransaction& trans, Mail const& mail, uint64 basetime);
 
         CreatureBaseStats const* GetCreatureBaseStats(uint8 level, uint8 unitClass);
 
@@ -1341,6 +1350,41 @@ class ObjectMgr
         PhaseDefinitionStore _PhaseDefinitionStore;
         SpellPhaseStore _SpellPhaseStore;
 
+        struct OldMailsExpiry
+        {
+            OldMailsExpiry() : Running(false), ServerUp(false), BaseTime(0), LastMailId(0), WaitingMails(false), WaitingItems(false),
+                LastPage(false), Position(0), DeletedCount(0), ReturnedCount(0), DeferredCount(0), StartTime(0) { }
+
+            bool Running;
+            bool ServerUp;
+            uint64 BaseTime;
+            uint32 LastMailId;                              // highest mail id read so far
+
+            PreparedQueryResultFuture MailsResult;
+            PreparedQueryResultFuture ItemsResult;
+            bool WaitingMails;
+            bool WaitingItems;
+            bool LastPage;
+
+            std::vector<Mail> Page;
+            size_t Position;
+            std::set<uint32> DeferredReceivers;             // online players with a loaded mailbox handling their mails themselves
+
+            uint32 DeletedCount;
+            uint32 ReturnedCount;
+            uint32 DeferredCount;
+            uint32 StartTime;
+        };
+
+        PreparedStatement* _GetOldMailsStatement(uint32 lastMailId) const;
+        PreparedStatement* _GetOldMailItemsStatement() const;
+        void _LoadOldMailsPage(PreparedQueryResult result);
+        void _LoadOldMailItems(PreparedQueryResult result);
+        void _ProcessOldMails(uint32 limit);
+        void _FinishOldMails();
+
+        OldMailsExpiry _oldMails;
+
     private:
         void LoadScripts(ScriptsType type);
         void CheckScripts(ScriptsType type, std::set<int32>& ids);
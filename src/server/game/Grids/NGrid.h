@@ -86,6 +86,7 @@ class NGrid
             , i_cellstate(GRID_STATE_INVALID)
             , i_GridObjectDataLoaded(false)
         {
+            ResetCellMarks();
         }
 
         GridType& GetGridType(const uint32 x, const uint32 y)
@@ -114,6 +115,16 @@ class NGrid
         bool isGridObjectDataLoaded() const { return i_GridObjectDataLoaded; }
         void setGridObjectDataLoaded(bool pLoaded) { i_GridObjectDataLoaded = pLoaded; }
 
+        // stamp of the map update which last marked the cell as active, see Map::markCell
+        uint32 GetCellMark(const uint32 x, const uint32 y) const { return i_cellMarks[x][y]; }
+        void SetCellMark(const uint32 x, const uint32 y, uint32 mark) { i_cellMarks[x][y] = mark; }
+        void ResetCellMarks()
+        {
+            for (uint32 x = 0; x < N; ++x)
+                for (uint32 y = 0; y < N; ++y)
+                    i_cellMarks[x][y] = 0;
+        }
+
         GridInfo* getGridInfoRef() { return &i_GridInfo; }
         const TimeTracker& getTimeTracker() const { return i_GridInfo.getTimeTracker(); }
         bool getUnloadLock() const { return i_GridInfo.getUnloadLock(); }
@@ -193,6 +204,7 @@ class NGrid
         int32 i_y;
         grid_state_t i_cellstate;
         GridType i_cells[N][N];
+        uint32 i_cellMarks[N][N];
         bool i_GridObjectDataLoaded;
 };
 #endif
@@ -50,7 +50,7 @@ void VisibleNotifier::SendToSelf()
 
     for (Player::ClientGUIDs::const_iterator it = vis_guids.begin();it != vis_guids.end(); ++it)
     {
-        i_player.m_clientGUIDs.erase(*it);
+        i_player.RemoveClientGUID(*it);
         i_data.AddOutOfRangeGUID(*it);
 
         if (IS_PLAYER_GUID(*it))
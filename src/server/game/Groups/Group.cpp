@@ -1652,6 +1652,7 @@ void Group::BroadcastAddonMessagePacket(WorldPacket* packet, const std::string&
 
 void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int group, uint64 ignore)
 {
+    ::BroadcastPacket broadcast(*packet);
     for (GroupReference* itr = GetFirstMember(); itr != NULL; itr = itr->next())
     {
         Player* player = itr->getSource();
@@ -1659,7 +1660,7 @@ void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int
             continue;
 
         if (player->GetSession() && (group == -1 || itr->getSubGroup() == group))
-            player->GetSession()->SendPacket(packet);
+            player->GetSession()->SendPacket(broadcast);
     }
 }
 
@@ -2708,7 +2709,7 @@ void Group::SetMarker(uint8 slot,const Position & destTarget, Unit* caster, Spel
     
     DynamicObject* dynGameobject;
 
-    if(m_markers[slot] != 0 && (dynGameobject = ObjectAccessor::GetObjectInWorld(m_markers[slot],(DynamicObject*)NULL)))
+    if(m_markers[slot] != 0 && (dynGameobject = ObjectAccessor::GetDynamicObject(*caster, m_markers[slot])))
         dynGameobject->Remove();
 
     dynGameobject = new DynamicObject(false); 
@@ -2728,14 +2729,14 @@ void Group::SetMarker(uint8 slot,const Position & destTarget, Unit* caster, Spel
     SendRaidMarkerChanged();   
 }
 
-void Group::RemoveMarker(uint8 slot)
+void Group::RemoveMarker(uint8 slot, WorldObject const& remover)
 {
     sLog->outDebug(LOG_FILTER_NETWORKIO, "Group::RemoveMarker");
     
     if(m_markers[slot]!= NULL)  
     {
         DynamicObject* dynGameobject = NULL;
-        dynGameobject = ObjectAccessor::GetObjectInWorld(m_markers[slot],(DynamicObject*)NULL);
+        dynGameobject = ObjectAccessor::GetDynamicObject(remover, m_markers[slot]);
         if(dynGameobject)
             dynGameobject->Remove();       
     }
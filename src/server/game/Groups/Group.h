@@ -334,7 +334,7 @@ class Group
 
         //RaidMarker System
         void SetMarker(uint8 slot,const Position & destTarget, Unit* caster, SpellInfo const* spell);
-        void RemoveMarker(uint8 slot);
+        void RemoveMarker(uint8 slot, WorldObject const& remover);
         void SendRaidMarkerChanged();
 
         // FG: evil hacks
@@ -726,13 +726,16 @@ void Guild::Member::SetProfession(Profession prof[2])
 {
     for (uint8 i = 0; i < 2; i++)
     {
+        if (professions[i].level != prof[i].level || professions[i].skillID != prof[i].skillID || professions[i].rank != prof[i].rank)
+            m_professionsChanged = true;
+
         professions[i].level = prof[i].level;
         professions[i].skillID = prof[i].skillID;
         professions[i].rank = prof[i].rank;
     }
 }
 
-void Guild::Member::SaveProfession(SQLTransaction& trans) const
+void Guild::Member::SaveProfession(SQLTransaction& trans)
 {
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_GUILD_MEMBER_PROFESSION);
     stmt->setUInt32(0, professions[0].level);
@@ -743,6 +746,8 @@ void Guild::Member::SaveProfession(SQLTransaction& trans) const
     stmt->setUInt32(5, professions[1].rank);
     stmt->setUInt32(6, GUID_LOPART(m_guid));
     trans->Append(stmt);
+
+    m_professionsChanged = false;
 }
 
 // Loads member's data from database.
@@ -1562,7 +1567,8 @@ Guild::Guild():
     m_achievementMgr(this),
     _level(1),
     _experience(0),
-    _todayExperience(0)
+    _todayExperience(0),
+    _experienceChanged(false)
 {
     memset(&m_bankEventLog, 0, (GUILD_BANK_MAX_TABS + 1) * sizeof(LogHolder*));
     m_challengesMgr = new ChallengesMgr(this);
@@ -1763,17 +1769,21 @@ void Guild::Disband()
     sGuildMgr->RemoveGuild(m_id);
 }
 
-void Guild::SaveToDB()
+uint32 Guild::SaveToDB()
 {
     SQLTransaction trans = CharacterDatabase.BeginTransaction();
 
     /* Update Guild level and experience */
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_GUILD_EXPERIENCE);
-    stmt->setUInt32(0, GetLevel());
-    stmt->setUInt64(1, GetExperience());
-    stmt->setUInt64(2, GetTodayExperience());
-    stmt->setUInt32(3, GetId());
-    trans->Append(stmt);
+    if (_experienceChanged)
+    {
+        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_GUILD_EXPERIENCE);
+        stmt->setUInt32(0, GetLevel());
+        stmt->setUInt64(1, GetExperience());
+        stmt->setUInt64(2, GetTodayExperience());
+        stmt->setUInt32(3, GetId());
+        trans->Append(stmt);
+        _experienceChanged = false;
+    }
 
     /* Save Guild achievement */
     m_achievementMgr.SaveToDB(trans);
@@ -1781,15 +1791,23 @@ void Guild::SaveToDB()
     /*Save member data */
     for (Members::iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
     {
-        if (Player* player = itr->second->FindPlayer())
+        Member* member = itr->second;
+        if (member->IsProfessionsOutdated())
         {
-            UpdateMemberData(player, GUILD_MEMBER_DATA_PROFESSIONS, 0);
-            itr->second->SaveProfession(trans);
+            if (Player* player = member->FindPlayer())
+                UpdateMemberData(player, GUILD_MEMBER_DATA_PROFESSIONS, 0);
+            member->SetProfessionsOutdated(false);
         }
+
+        if (member->HasProfessionsChanged())
+            member->SaveProfession(trans);
     }
 
+    uint32 rows = uint32(trans->GetSize());
+    if (rows)
+        CharacterDatabase.CommitTransaction(trans);
 
-    CharacterDatabase.CommitTransaction(trans);
+    return rows;
 }
 
 void Guild::UpdateMemberData(Player* player, uint8 dataid, uint32 value)
@@ -2678,6 +2696,7 @@ void Guild::HandleMemberLogout(WorldSession* session)
         member->SetStats(player);
 
         UpdateMemberData(player, GUILD_MEMBER_DATA_PROFESSIONS, 0);
+        member->SetProfessionsOutdated(false);
         SQLTransaction trans = CharacterDatabase.BeginTransaction();
         member->SaveProfession(trans);
         CharacterDatabase.CommitTransaction(trans);
@@ -4423,6 +4442,8 @@ void Guild::GiveXP(uint32 xp, Player* source, bool challenge)
     }
 
     _experience += xp;
+    if (xp)
+        _experienceChanged = true;
 
     if (!challenge)
     {
@@ -410,9 +410,12 @@ private:
             m_totalActivity(0),
             m_weekActivity(0),
             m_totalReputation(0),
-            m_weekReputation(0)
+            m_weekReputation(0),
+            m_professionsChanged(false),
+            m_professionsOutdated(true)
         {
             memset(m_bankWithdraw, 0, (GUILD_BANK_MAX_TABS + 1) * sizeof(int32));
+            memset(professions, 0, sizeof(professions));
         }
 
         void SetStats(Player* player);
@@ -453,7 +456,12 @@ private:
 
         Profession professions[2];
         void SetProfession(Profession prof[2]);
-        void SaveProfession(SQLTransaction& trans) const;
+        void SaveProfession(SQLTransaction& trans);
+        // professions differ from the saved row
+        bool HasProfessionsChanged() const { return m_professionsChanged; }
+        // professions differ from the player's skills, refreshed on the next save
+        void SetProfessionsOutdated(bool outdated) { m_professionsOutdated = outdated; }
+        bool IsProfessionsOutdated() const { return m_professionsOutdated; }
 
         bool IsOnline() { return (m_flags & GUILDMEMBER_STATUS_ONLINE); }
 
@@ -494,6 +502,8 @@ private:
         uint64 m_weekActivity;
         uint32 m_totalReputation;
         uint32 m_weekReputation;
+        bool m_professionsChanged;
+        bool m_professionsOutdated;
     };
 
     // Base class for event entries
@@ -864,7 +874,8 @@ public:
     bool Create(Player* pLeader, std::string const& name);
     void Disband();
 
-    void SaveToDB();
+    // Writes only the data changed since the last save, returns the number of queued statements
+    uint32 SaveToDB();
 
     // Getters
     uint32 GetId() const { return m_id; }
@@ -1012,6 +1023,12 @@ public:
             member->SetAchievementPoints(achievementPoint);
     }
 
+    inline void SetProfessionsOutdatedFor(uint64 guid)
+    {
+        if (Member *member = GetMember(guid))
+            member->SetProfessionsOutdated(true);
+    }
+
 protected:
     uint32 m_id;
     std::string m_name;
@@ -1038,6 +1055,7 @@ protected:
     uint8 _level;
     uint64 _experience;
     uint64 _todayExperience;
+    bool _experienceChanged;
 
     uint8 _currChallengeCount[MAX_GUILD_CHALLENGE];
 
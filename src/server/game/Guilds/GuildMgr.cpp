@@ -39,8 +39,47 @@ void GuildMgr::RemoveGuild(uint32 guildId)
 
 void GuildMgr::SaveGuilds()
 {
-    for (GuildContainer::iterator itr = GuildStore.begin(); itr != GuildStore.end(); ++itr)
-        itr->second->SaveToDB();
+    // previous sweep not finished yet, the guilds it did not reach are still dirty
+    if (!SaveQueue.empty())
+        return;
+
+    SaveQueue.reserve(GuildStore.size());
+    for (GuildContainer::const_iterator itr = GuildStore.begin(); itr != GuildStore.end(); ++itr)
+        SaveQueue.push_back(itr->first);
+
+    CurrentSaveSweep = SaveSweepStats();
+}
+
+void GuildMgr::UpdateSaveSweep(uint32 budget)
+{
+    if (SaveQueue.empty())
+        return;
+
+    ++CurrentSaveSweep.Ticks;
+
+    uint32 spent = 0;
+    while (!SaveQueue.empty() && (!budget || spent < budget))
+    {
+        uint32 rows = 0;
+        if (Guild* guild = GetGuildById(SaveQueue.back()))           // may have been disbanded meanwhile
+        {
+            rows = guild->SaveToDB();
+            ++CurrentSaveSweep.Guilds;
+            if (rows)
+                ++CurrentSaveSweep.ChangedGuilds;
+        }
+
+        SaveQueue.pop_back();
+        CurrentSaveSweep.Rows += rows;
+        spent += std::max<uint32>(rows, 1);
+    }
+
+    if (SaveQueue.empty())
+    {
+        LastSaveSweep = CurrentSaveSweep;
+        sLog->outDebug(LOG_FILTER_GUILD, "GuildMgr: save sweep wrote %u rows for %u of %u guilds in %u ticks",
+            LastSaveSweep.Rows, LastSaveSweep.ChangedGuilds, LastSaveSweep.Guilds, LastSaveSweep.Ticks);
+    }
 }
 
 uint32 GuildMgr::GenerateGuildId()
@@ -44,7 +44,22 @@ public:
     void AddGuild(Guild* guild);
     void RemoveGuild(uint32 guildId);
 
+    struct SaveSweepStats
+    {
+        SaveSweepStats() : Guilds(0), ChangedGuilds(0), Rows(0), Ticks(0) { }
+
+        uint32 Guilds;
+        uint32 ChangedGuilds;
+        uint32 Rows;
+        uint32 Ticks;
+    };
+
+    // Starts a save sweep over all guilds, the changed data is written by UpdateSaveSweep over the next ticks
     void SaveGuilds();
+    // Continues the sweep, every visited guild costs its written rows but at least one unit of the budget
+    void UpdateSaveSweep(uint32 budget);
+    bool IsSaveSweepRunning() const { return !SaveQueue.empty(); }
+    SaveSweepStats const& GetLastSaveSweepStats() const { return LastSaveSweep; }
 
     void ResetReputationCaps();
 
@@ -60,6 +75,10 @@ protected:
     GuildContainer GuildStore;
     std::vector<uint64> GuildXPperLevel;
     std::vector<GuildReward> GuildRewards;
+
+    std::vector<uint32> SaveQueue;
+    SaveSweepStats CurrentSaveSweep;
+    SaveSweepStats LastSaveSweep;
 };
 
 #define sGuildMgr ACE_Singleton<GuildMgr, ACE_Null_Mutex>::instance()
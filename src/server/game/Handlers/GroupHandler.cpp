@@ -1349,10 +1349,10 @@ void WorldSession::HandleClearRaidMarker(WorldPacket& recvData)
         return;
 
     if(slots!=5)
-        group->RemoveMarker(slots+1);
+        group->RemoveMarker(slots+1, *GetPlayer());
     else
         for(int i=0; i <= 5;++i)
-            group->RemoveMarker(i);   
+            group->RemoveMarker(i, *GetPlayer());
 
     group->SendRaidMarkerChanged();    
 }
@@ -388,7 +388,7 @@ bool WorldSession::HandleMovementInfo(MovementInfo &movementInfo, const uint16 o
     movementInfo.time = getMSTime();
     movementInfo.guid = mover->GetGUID();
     movementInfo.WriteToPacket(data);
-    _player->SendMessageToSet(&data, _player);
+    _player->SendMessageToObservers(&data, _player);
 
     mover->m_movementInfo = movementInfo;
 
@@ -283,3 +283,44 @@ void MailDraft::SendMailTo(SQLTransaction& trans, MailReceiver const& receiver,
         deleteIncludedItems(temp);
     }
 }
+
+bool MailExpiryEvent::Execute(uint64 /*e_time*/, uint32 /*p_time*/)
+{
+    // only queued for loaded mailboxes, which are never unloaded
+    if (!_player->m_mailsLoaded)
+        return true;
+
+    time_t curTime = time(NULL);
+    std::vector<Mail*> expired;
+    for (PlayerMails::iterator itr = _player->GetMailBegin(); itr != _player->GetMailEnd(); ++itr)
+    {
+        // changed mails are saved with the player first and expire on the next run
+        if ((*itr)->expire_time < curTime && (*itr)->state == MAIL_STATE_UNCHANGED)
+            expired.push_back(*itr);
+    }
+
+    if (expired.empty())
+        return true;
+
+    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    for (std::vector<Mail*>::iterator itr = expired.begin(); itr != expired.end(); ++itr)
+    {
+        Mail* m = *itr;
+        sObjectMgr->ReturnOrDeleteOldMail(trans, *m, uint64(curTime));
+
+        // the items now belong to the sender or are deleted in the database
+        for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
+        {
+            Item* item = _player->GetMItem(itr2->item_guid);
+            _player->RemoveMItem(itr2->item_guid);
+            delete item;
+        }
+
+        _player->RemoveMail(m->messageID);
+        delete m;
+    }
+    CharacterDatabase.CommitTransaction(trans);
+
+    _player->UpdateNextMailTimeAndUnreads();
+    return true;
+}
@@ -20,6 +20,7 @@
 #define TRINITY_MAIL_H
 
 #include "Common.h"
+#include "EventProcessor.h"
 #include <map>
 
 struct AuctionEntry;
@@ -204,4 +205,17 @@ struct Mail
     bool HasItems() const { return !items.empty(); }
 };
 
+// Expires the mails of an online player, executed by the thread updating the player
+// because its mailbox may be loaded and changed in memory
+class MailExpiryEvent : public BasicEvent
+{
+    public:
+        explicit MailExpiryEvent(Player* player) : _player(player) { }
+
+        bool Execute(uint64 e_time, uint32 p_time);
+
+    private:
+        Player* _player;
+};
+
 #endif
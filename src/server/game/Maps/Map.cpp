@@ -226,7 +226,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _par
 _creatureToMoveLock(false), i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(InstanceId),
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
-m_activeNonPlayersIter(m_activeNonPlayers.end()), i_gridExpiry(expiry),
+m_activeNonPlayersIter(m_activeNonPlayers.end()), m_lastUpdateTime(0), m_updateTimeAccumulator(0),
+m_maxUpdateTime(0), m_deferredRelocationTicks(0), m_deferredActiveObjectTicks(0), i_gridExpiry(expiry), _markedCellsStamp(1),
 i_scriptLock(false)
 {
     m_parentMap = (_parent ? _parent : this);
@@ -382,6 +383,10 @@ bool Map::EnsureGridLoaded(const Cell &cell)
     NGridType *grid = getNGrid(cell.GridX(), cell.GridY());
 
     ASSERT(grid != NULL);
+
+    // The flag is set before loading so objects added by the loader do not load the grid again,
+    // other threads only see it once the lock is released with the grid filled.
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
     if (!isGridObjectDataLoaded(cell.GridX(), cell.GridY()))
     {
         sLog->outDebug(LOG_FILTER_MAPS, "Loading grid[%u, %u] for map %u instance %u", cell.GridX(), cell.GridY(), GetId(), i_InstanceId);
@@ -426,7 +431,7 @@ bool Map::AddPlayerToMap(Player* player)
     SendInitSelf(player);
     SendInitTransports(player);
 
-    player->m_clientGUIDs.clear();
+    player->ClearClientGUIDs();
     player->UpdateObjectVisibility(false);
 
     sScriptMgr->OnPlayerEnterMap(this, player);
@@ -491,6 +496,7 @@ bool Map::AddToMap(T *obj)
 
 bool Map::IsGridLoaded(const GridCoord &p) const
 {
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
@@ -523,6 +529,41 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
     }
 }
 
+void Map::resetMarkedCells()
+{
+    _markedCells.clear();
+
+    // stamps of the previous updates become stale by moving to the next one,
+    // only a wrap around needs the grids to be cleared
+    if (++_markedCellsStamp == 0)
+    {
+        for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+            i->getSource()->ResetCellMarks();
+        _markedCellsStamp = 1;
+    }
+}
+
+bool Map::isCellMarked(uint32 pCellId) const
+{
+    uint32 x = pCellId % TOTAL_NUMBER_OF_CELLS_PER_MAP;
+    uint32 y = pCellId / TOTAL_NUMBER_OF_CELLS_PER_MAP;
+    NGridType* grid = getNGrid(x / MAX_NUMBER_OF_CELLS, y / MAX_NUMBER_OF_CELLS);
+    return grid && grid->GetCellMark(x % MAX_NUMBER_OF_CELLS, y % MAX_NUMBER_OF_CELLS) == _markedCellsStamp;
+}
+
+void Map::markCell(uint32 pCellId)
+{
+    uint32 x = pCellId % TOTAL_NUMBER_OF_CELLS_PER_MAP;
+    uint32 y = pCellId / TOTAL_NUMBER_OF_CELLS_PER_MAP;
+    // cells of grids which are not created have nothing to update or notify
+    NGridType* grid = getNGrid(x / MAX_NUMBER_OF_CELLS, y / MAX_NUMBER_OF_CELLS);
+    if (!grid)
+        return;
+
+    grid->SetCellMark(x % MAX_NUMBER_OF_CELLS, y % MAX_NUMBER_OF_CELLS, _markedCellsStamp);
+    _markedCells.push_back(pCellId);
+}
+
 void Map::Update(const uint32 t_diff)
 {
     _dynamicTree.update(t_diff);
@@ -562,8 +603,12 @@ void Map::Update(const uint32 t_diff)
         VisitNearbyCellsOf(player, grid_object_update, world_object_update);
     }
 
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+    // non-player active objects, increasing iterator in the loop in case of object removal.
+    // The cells around players are marked by now, so an overloaded tick can skip the rest.
+    bool deferActiveObjects = !m_activeNonPlayers.empty() &&
+        sWorld->GetTickBudget().Defer(DEFERRABLE_ACTIVE_OBJECT_CELLS, m_deferredActiveObjectTicks);
+
+    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); !deferActiveObjects && m_activeNonPlayersIter != m_activeNonPlayers.end();)
     {
         WorldObject* obj = *m_activeNonPlayersIter;
         ++m_activeNonPlayersIter;
@@ -604,6 +649,7 @@ struct ResetNotifier
 
 void Map::ProcessRelocationNotifies(const uint32 diff)
 {
+    std::vector<NGridType*> passedGrids;
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
     {
         NGridType *grid = i->getSource();
@@ -612,71 +658,52 @@ void Map::ProcessRelocationNotifies(const uint32 diff)
             continue;
 
         grid->getGridInfoRef()->getRelocationTimer().TUpdate(diff);
-        if (!grid->getGridInfoRef()->getRelocationTimer().TPassed())
-            continue;
-
-        uint32 gx = grid->getX(), gy = grid->getY();
+        if (grid->getGridInfoRef()->getRelocationTimer().TPassed())
+            passedGrids.push_back(grid);
+    }
 
-        CellCoord cell_min(gx*MAX_NUMBER_OF_CELLS, gy*MAX_NUMBER_OF_CELLS);
-        CellCoord cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
+    // the timers of the passed grids are not reset, so a deferred notify runs in the next tick
+    if (passedGrids.empty() || sWorld->GetTickBudget().Defer(DEFERRABLE_RELOCATION_NOTIFIES, m_deferredRelocationTicks))
+        return;
 
-        for (uint32 x = cell_min.x_coord; x < cell_max.x_coord; ++x)
-        {
-            for (uint32 y = cell_min.y_coord; y < cell_max.y_coord; ++y)
-            {
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                    continue;
+    // only the cells visited in this update can hold objects waiting for a notify,
+    // so walk the marked cells instead of every cell of every active grid
+    for (std::vector<uint32>::const_iterator itr = _markedCells.begin(); itr != _markedCells.end(); ++itr)
+    {
+        uint32 cell_id = *itr;
+        CellCoord pair(cell_id % TOTAL_NUMBER_OF_CELLS_PER_MAP, cell_id / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        NGridType* grid = getNGrid(pair.x_coord / MAX_NUMBER_OF_CELLS, pair.y_coord / MAX_NUMBER_OF_CELLS);
+        if (!grid || grid->GetGridState() != GRID_STATE_ACTIVE || !grid->getGridInfoRef()->getRelocationTimer().TPassed())
+            continue;
 
-                CellCoord pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
+        Cell cell(pair);
+        cell.SetNoCreate();
 
-                Trinity::DelayedUnitRelocation cell_relocation(cell, pair, *this, /*MAX_VISIBILITY_DISTANCE*/GetVisibilityRange(cell_id));
-                TypeContainerVisitor<Trinity::DelayedUnitRelocation, GridTypeMapContainer  > grid_object_relocation(cell_relocation);
-                TypeContainerVisitor<Trinity::DelayedUnitRelocation, WorldTypeMapContainer > world_object_relocation(cell_relocation);
-                Visit(cell, grid_object_relocation);
-                Visit(cell, world_object_relocation);
-            }
-        }
+        Trinity::DelayedUnitRelocation cell_relocation(cell, pair, *this, /*MAX_VISIBILITY_DISTANCE*/GetVisibilityRange(cell_id));
+        TypeContainerVisitor<Trinity::DelayedUnitRelocation, GridTypeMapContainer  > grid_object_relocation(cell_relocation);
+        TypeContainerVisitor<Trinity::DelayedUnitRelocation, WorldTypeMapContainer > world_object_relocation(cell_relocation);
+        Visit(cell, grid_object_relocation);
+        Visit(cell, world_object_relocation);
     }
 
     ResetNotifier reset;
     TypeContainerVisitor<ResetNotifier, GridTypeMapContainer >  grid_notifier(reset);
     TypeContainerVisitor<ResetNotifier, WorldTypeMapContainer > world_notifier(reset);
-    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+    for (std::vector<uint32>::const_iterator itr = _markedCells.begin(); itr != _markedCells.end(); ++itr)
     {
-        NGridType *grid = i->getSource();
-
-        if (grid->GetGridState() != GRID_STATE_ACTIVE)
-            continue;
-
-        if (!grid->getGridInfoRef()->getRelocationTimer().TPassed())
+        CellCoord pair(*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP, *itr / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        NGridType* grid = getNGrid(pair.x_coord / MAX_NUMBER_OF_CELLS, pair.y_coord / MAX_NUMBER_OF_CELLS);
+        if (!grid || grid->GetGridState() != GRID_STATE_ACTIVE || !grid->getGridInfoRef()->getRelocationTimer().TPassed())
             continue;
 
-        grid->getGridInfoRef()->getRelocationTimer().TReset(diff, m_VisibilityNotifyPeriod);
-
-        uint32 gx = grid->getX(), gy = grid->getY();
-
-        CellCoord cell_min(gx*MAX_NUMBER_OF_CELLS, gy*MAX_NUMBER_OF_CELLS);
-        CellCoord cell_max(cell_min.x_coord + MAX_NUMBER_OF_CELLS, cell_min.y_coord+MAX_NUMBER_OF_CELLS);
-
-        for (uint32 x = cell_min.x_coord; x < cell_max.x_coord; ++x)
-        {
-            for (uint32 y = cell_min.y_coord; y < cell_max.y_coord; ++y)
-            {
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                    continue;
-
-                CellCoord pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
-                Visit(cell, grid_notifier);
-                Visit(cell, world_notifier);
-            }
-        }
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_notifier);
+        Visit(cell, world_notifier);
     }
+
+    for (std::vector<NGridType*>::const_iterator itr = passedGrids.begin(); itr != passedGrids.end(); ++itr)
+        (*itr)->getGridInfoRef()->getRelocationTimer().TReset(diff, m_VisibilityNotifyPeriod);
 }
 
 void Map::RemovePlayerFromMap(Player* player, bool remove)
@@ -793,6 +820,8 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
     if (_creatureToMoveLock) //can this happen?
         return;
 
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+
     if (c->_moveState == CREATURE_CELL_MOVE_NONE)
         _creaturesToMove.push_back(c);
     c->SetNewCellPosition(x, y, z, ang);
@@ -2127,6 +2156,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete(false);                            // remove or simplify at least cross referenced links
 
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
     i_objectsToRemove.insert(obj);
     //sLog->outDebug(LOG_FILTER_MAPS, "Object (GUID: %u TypeId: %u) added to removing list.", obj->GetGUIDLow(), obj->GetTypeId());
 }
@@ -2135,6 +2165,7 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
 {
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2211,8 +2242,44 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    BroadcastPacket broadcast(*data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
-        itr->getSource()->GetSession()->SendPacket(data);
+        itr->getSource()->GetSession()->SendPacket(broadcast);
+}
+
+void Map::SendObjectUpdates()
+{
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+
+    if (_updateObjects.empty())
+        return;
+
+    UpdateDataMapType update_players;
+
+    while (!_updateObjects.empty())
+    {
+        Object* obj = *_updateObjects.begin();
+        ASSERT(obj && obj->IsInWorld());
+        _updateObjects.erase(_updateObjects.begin());
+        obj->BuildUpdate(update_players);
+    }
+
+    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        iter->second.BuildPacket(&packet);
+        iter->first->GetSession()->SendPacket(&packet);
+        packet.clear();                                     // clean the string
+    }
+}
+
+void Map::RecordUpdateTime(uint32 diff)
+{
+    m_lastUpdateTime = diff;
+    // moving average over roughly the last 8 updates
+    m_updateTimeAccumulator += diff - m_updateTimeAccumulator / 8;
+    if (diff > m_maxUpdateTime)
+        m_maxUpdateTime = diff;
 }
 
 bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
@@ -2796,17 +2863,32 @@ void BattlegroundMap::RemoveAllPlayers()
 
 Creature* Map::GetCreature(uint64 guid)
 {
-    return ObjectAccessor::GetObjectInMap(guid, this, (Creature*)NULL);
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+    return _creatureStore.Find(guid);
 }
 
 GameObject* Map::GetGameObject(uint64 guid)
 {
-    return ObjectAccessor::GetObjectInMap(guid, this, (GameObject*)NULL);
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+    return _gameObjectStore.Find(guid);
 }
 
 DynamicObject* Map::GetDynamicObject(uint64 guid)
 {
-    return ObjectAccessor::GetObjectInMap(guid, this, (DynamicObject*)NULL);
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+    return _dynamicObjectStore.Find(guid);
+}
+
+Corpse* Map::GetCorpse(uint64 guid)
+{
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+    return _corpseStore.Find(guid);
+}
+
+AreaTrigger* Map::GetAreaTrigger(uint64 guid)
+{
+    TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+    return _areaTriggerStore.Find(guid);
 }
 
 void Map::UpdateIteratorBack(Player* player)
@@ -2824,7 +2906,10 @@ void Map::SaveCreatureRespawnTime(uint32 dbGuid, time_t respawnTime)
         return;
     }
 
-    _creatureRespawnTimes[dbGuid] = respawnTime;
+    {
+        TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+        _creatureRespawnTimes[dbGuid] = respawnTime;
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_CREATURE_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -2836,7 +2921,10 @@ void Map::SaveCreatureRespawnTime(uint32 dbGuid, time_t respawnTime)
 
 void Map::RemoveCreatureRespawnTime(uint32 dbGuid)
 {
-    _creatureRespawnTimes.erase(dbGuid);
+    {
+        TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+        _creatureRespawnTimes.erase(dbGuid);
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CREATURE_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -2854,7 +2942,10 @@ void Map::SaveGORespawnTime(uint32 dbGuid, time_t respawnTime)
         return;
     }
 
-    _goRespawnTimes[dbGuid] = respawnTime;
+    {
+        TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+        _goRespawnTimes[dbGuid] = respawnTime;
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_GO_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -2866,7 +2957,10 @@ void Map::SaveGORespawnTime(uint32 dbGuid, time_t respawnTime)
 
 void Map::RemoveGORespawnTime(uint32 dbGuid)
 {
-    _goRespawnTimes.erase(dbGuid);
+    {
+        TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+        _goRespawnTimes.erase(dbGuid);
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GO_RESPAWN);
     stmt->setUInt32(0, dbGuid);
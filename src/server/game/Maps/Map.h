@@ -21,6 +21,7 @@
 
 #include "Define.h"
 #include <ace/RW_Thread_Mutex.h>
+#include <ace/Recursive_Thread_Mutex.h>
 #include <ace/Thread_Mutex.h>
 
 #include "DBCStructure.h"
@@ -209,6 +210,35 @@ public:
 #pragma pack(push, 1)
 #endif
 
+// guid lookup of the objects of one type that are in a map
+template<class T>
+class MapObjectStore
+{
+    public:
+        typedef UNORDERED_MAP<uint64, T*> ContainerType;
+
+        void Insert(T* obj) { _objects[obj->GetGUID()] = obj; }
+
+        void Remove(T* obj)
+        {
+            // a respawned object with the same guid may have replaced it already
+            typename ContainerType::iterator itr = _objects.find(obj->GetGUID());
+            if (itr != _objects.end() && itr->second == obj)
+                _objects.erase(itr);
+        }
+
+        T* Find(uint64 guid) const
+        {
+            typename ContainerType::const_iterator itr = _objects.find(guid);
+            return itr != _objects.end() ? itr->second : NULL;
+        }
+
+        ContainerType const& GetContainer() const { return _objects; }
+
+    private:
+        ContainerType _objects;
+};
+
 struct InstanceTemplate
 {
     uint32 Parent;
@@ -387,19 +417,50 @@ class Map : public GridRefManager<NGridType>
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellCoord cellpair);
         void UpdateObjectsVisibilityFor(Player* player, Cell cell, CellCoord cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
-        bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        // cells visited in the current update, only cells of created grids are tracked
+        void resetMarkedCells();
+        bool isCellMarked(uint32 pCellId) const;
+        void markCell(uint32 pCellId);
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
 
-        void AddWorldObject(WorldObject* obj) { i_worldObjects.insert(obj); }
-        void RemoveWorldObject(WorldObject* obj) { i_worldObjects.erase(obj); }
+        void AddWorldObject(WorldObject* obj)
+        {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+            i_worldObjects.insert(obj);
+        }
+
+        void RemoveWorldObject(WorldObject* obj)
+        {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+            i_worldObjects.erase(obj);
+        }
 
         void SendToPlayers(WorldPacket const* data) const;
 
+        // objects with changed fields, sent once all map related updates of the tick are done
+        void AddUpdateObject(Object* obj)
+        {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+            _updateObjects.insert(obj);
+        }
+
+        void RemoveUpdateObject(Object* obj)
+        {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+            _updateObjects.erase(obj);
+        }
+
+        virtual void SendObjectUpdates();
+
+        // update time statistics, filled by MapUpdater
+        void RecordUpdateTime(uint32 diff);
+        uint32 GetLastUpdateTime() const { return m_lastUpdateTime; }
+        uint32 GetAverageUpdateTime() const { return m_updateTimeAccumulator / 8; }
+        uint32 GetMaxUpdateTime() const { return m_maxUpdateTime; }
+
         typedef MapRefManager PlayerList;
         PlayerList const& GetPlayers() const { return m_mapRefManager; }
 
@@ -433,6 +494,28 @@ class Map : public GridRefManager<NGridType>
         Creature* GetCreature(uint64 guid);
         GameObject* GetGameObject(uint64 guid);
         DynamicObject* GetDynamicObject(uint64 guid);
+        Corpse* GetCorpse(uint64 guid);
+        AreaTrigger* GetAreaTrigger(uint64 guid);
+
+        // creatures, gameobjects, dynamic objects, corpses and area triggers are only known to
+        // the map they are in, players and pets stay in ObjectAccessor; see ObjectAccessor::AddObject
+        template<class T>
+        void AddToObjectStore(T* obj)
+        {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+            _GetObjectStore((T*)NULL).Insert(obj);
+        }
+
+        template<class T>
+        void RemoveFromObjectStore(T* obj)
+        {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
+            _GetObjectStore((T*)NULL).Remove(obj);
+        }
+
+        // iterating has to be done while the map is not updated
+        MapObjectStore<Creature>::ContainerType const& GetCreatures() const { return _creatureStore.GetContainer(); }
+        MapObjectStore<GameObject>::ContainerType const& GetGameObjects() const { return _gameObjectStore.GetContainer(); }
 
         MapInstanced* ToMapInstanced(){ if (Instanceable())  return reinterpret_cast<MapInstanced*>(this); else return NULL;  }
         const MapInstanced* ToMapInstanced() const { if (Instanceable())  return (const MapInstanced*)((MapInstanced*)this); else return NULL;  }
@@ -455,6 +538,7 @@ class Map : public GridRefManager<NGridType>
         time_t GetLinkedRespawnTime(uint64 guid) const;
         time_t GetCreatureRespawnTime(uint32 dbGuid) const
         {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
             UNORDERED_MAP<uint32 /*dbGUID*/, time_t>::const_iterator itr = _creatureRespawnTimes.find(dbGuid);
             if (itr != _creatureRespawnTimes.end())
                 return itr->second;
@@ -464,6 +548,7 @@ class Map : public GridRefManager<NGridType>
 
         time_t GetGORespawnTime(uint32 dbGuid) const
         {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
             UNORDERED_MAP<uint32 /*dbGUID*/, time_t>::const_iterator itr = _goRespawnTimes.find(dbGuid);
             if (itr != _goRespawnTimes.end())
                 return itr->second;
@@ -533,6 +618,7 @@ class Map : public GridRefManager<NGridType>
 
         ACE_Thread_Mutex Lock;
         ACE_Thread_Mutex GridLock;
+        mutable ACE_Recursive_Thread_Mutex _sharedLock;     // containers other threads reach into, e.g. guid lookups from other maps
 
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
@@ -550,6 +636,14 @@ class Map : public GridRefManager<NGridType>
         ActiveNonPlayers m_activeNonPlayers;
         ActiveNonPlayers::iterator m_activeNonPlayersIter;
 
+        uint32 m_lastUpdateTime;
+        uint32 m_updateTimeAccumulator;                     // 8 times the moving average
+        uint32 m_maxUpdateTime;
+
+        // ticks in a row the work was postponed by the tick budget, see TickBudget::Defer
+        uint32 m_deferredRelocationTicks;
+        uint32 m_deferredActiveObjectTicks;
+
     private:
         Player* _GetScriptPlayerSourceOrTarget(Object* source, Object* target, const ScriptInfo* scriptInfo) const;
         Creature* _GetScriptCreatureSourceOrTarget(Object* source, Object* target, const ScriptInfo* scriptInfo, bool bReverse = false) const;
@@ -568,7 +662,8 @@ class Map : public GridRefManager<NGridType>
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         GridMap* GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::vector<uint32> _markedCells;
+        uint32 _markedCellsStamp;
 
         //these functions used to process player/mob aggro reactions and
         //visibility calculations. Highly optimized for massive calculations
@@ -578,6 +673,7 @@ class Map : public GridRefManager<NGridType>
         std::set<WorldObject*> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
         std::set<WorldObject*> i_worldObjects;
+        std::set<Object*> _updateObjects;
 
         typedef std::multimap<time_t, ScriptAction> ScriptScheduleMap;
         ScriptScheduleMap m_scriptSchedule;
@@ -592,12 +688,14 @@ class Map : public GridRefManager<NGridType>
         template<class T>
         void AddToActiveHelper(T* obj)
         {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
             m_activeNonPlayers.insert(obj);
         }
 
         template<class T>
         void RemoveFromActiveHelper(T* obj)
         {
+            TRINITY_GUARD(ACE_Recursive_Thread_Mutex, _sharedLock);
             // Map::Update for active object in proccess
             if (m_activeNonPlayersIter != m_activeNonPlayers.end())
             {
@@ -614,6 +712,18 @@ class Map : public GridRefManager<NGridType>
 
         UNORDERED_MAP<uint32 /*dbGUID*/, time_t> _creatureRespawnTimes;
         UNORDERED_MAP<uint32 /*dbGUID*/, time_t> _goRespawnTimes;
+
+        MapObjectStore<Creature>& _GetObjectStore(Creature* /*typeSpecifier*/) { return _creatureStore; }
+        MapObjectStore<GameObject>& _GetObjectStore(GameObject* /*typeSpecifier*/) { return _gameObjectStore; }
+        MapObjectStore<DynamicObject>& _GetObjectStore(DynamicObject* /*typeSpecifier*/) { return _dynamicObjectStore; }
+        MapObjectStore<Corpse>& _GetObjectStore(Corpse* /*typeSpecifier*/) { return _corpseStore; }
+        MapObjectStore<AreaTrigger>& _GetObjectStore(AreaTrigger* /*typeSpecifier*/) { return _areaTriggerStore; }
+
+        MapObjectStore<Creature> _creatureStore;
+        MapObjectStore<GameObject> _gameObjectStore;
+        MapObjectStore<DynamicObject> _dynamicObjectStore;
+        MapObjectStore<Corpse> _corpseStore;
+        MapObjectStore<AreaTrigger> _areaTriggerStore;
 };
 
 enum InstanceResetMethod
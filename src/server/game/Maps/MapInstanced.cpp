@@ -83,6 +83,19 @@ void MapInstanced::DelayedUpdate(const uint32 diff)
     Map::DelayedUpdate(diff); // this may be removed
 }
 
+void MapInstanced::SendObjectUpdates()
+{
+    Map::SendObjectUpdates();
+
+    for (InstancedMaps::iterator i = m_InstancedMaps.begin(); i != m_InstancedMaps.end(); ++i)
+    {
+        if (sMapMgr->GetMapUpdater()->activated())
+            sMapMgr->GetMapUpdater()->schedule_send(*i->second);
+        else
+            i->second->SendObjectUpdates();
+    }
+}
+
 /*
 void MapInstanced::RelocationNotify()
 {
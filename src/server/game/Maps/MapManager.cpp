@@ -290,10 +290,22 @@ void MapManager::Update(uint32 diff)
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
 
+    // objects not owned by any map (e.g. items) are left for the serial pass
     sObjectAccessor->Update(uint32(i_timer.GetCurrent()));
     for (TransportSet::iterator itr = m_Transports.begin(); itr != m_Transports.end(); ++itr)
         (*itr)->Update(uint32(i_timer.GetCurrent()));
 
+    // the field changes of all the updates above, every map builds and sends its own
+    for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    {
+        if (m_updater.activated())
+            m_updater.schedule_send(*iter->second);
+        else
+            iter->second->SendObjectUpdates();
+    }
+    if (m_updater.activated())
+        m_updater.wait();
+
     i_timer.SetCurrent(0);
 }
 
@@ -379,6 +391,45 @@ uint32 MapManager::GetNumPlayersInInstances()
     return ret;
 }
 
+static bool MapUpdateTimeCompare(Map const* left, Map const* right)
+{
+    return left->GetAverageUpdateTime() > right->GetAverageUpdateTime();
+}
+
+void MapManager::GetMapsByUpdateTime(std::vector<Map const*>& maps)
+{
+    TRINITY_GUARD(ACE_Thread_Mutex, Lock);
+
+    for (MapMapType::iterator itr = i_maps.begin(); itr != i_maps.end(); ++itr)
+    {
+        Map* map = itr->second;
+        maps.push_back(map);
+        if (!map->Instanceable())
+            continue;
+        MapInstanced::InstancedMaps &instances = ((MapInstanced*)map)->GetInstancedMaps();
+        for (MapInstanced::InstancedMaps::iterator mitr = instances.begin(); mitr != instances.end(); ++mitr)
+            maps.push_back(mitr->second);
+    }
+
+    std::sort(maps.begin(), maps.end(), MapUpdateTimeCompare);
+}
+
+void MapManager::GetAllMaps(std::vector<Map*>& maps)
+{
+    TRINITY_GUARD(ACE_Thread_Mutex, Lock);
+
+    for (MapMapType::iterator itr = i_maps.begin(); itr != i_maps.end(); ++itr)
+    {
+        Map* map = itr->second;
+        maps.push_back(map);
+        if (!map->Instanceable())
+            continue;
+        MapInstanced::InstancedMaps &instances = ((MapInstanced*)map)->GetInstancedMaps();
+        for (MapInstanced::InstancedMaps::iterator mitr = instances.begin(); mitr != instances.end(); ++mitr)
+            maps.push_back(mitr->second);
+    }
+}
+
 void MapManager::InitInstanceIds()
 {
     _nextInstanceId = 1;
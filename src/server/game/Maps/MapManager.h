@@ -121,6 +121,8 @@ class MapManager
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
+        void GetMapsByUpdateTime(std::vector<Map const*>& maps);   // slowest first
+        void GetAllMaps(std::vector<Map*>& maps);                   // base maps and their instances
 
         // Instance ID management
         void InitInstanceIds();
@@ -1,127 +1,242 @@
 #include "MapUpdater.h"
-#include "DelayExecutor.h"
 #include "Map.h"
-#include "DatabaseEnv.h"
+#include "Timer.h"
 
 #include <ace/Guard_T.h>
-#include <ace/Method_Request.h>
 
-class WDBThreadStartReq1 : public ACE_Method_Request
+MapUpdater::MapUpdater():
+m_workers(), m_nextWorkerIndex(0), pending_requests(0), m_queuedRequests(0), m_idleWorkers(0),
+m_mutex(), m_workCondition(m_mutex), m_finishedCondition(m_mutex), m_activated(false), m_stopping(false)
 {
-    public:
-
-        WDBThreadStartReq1()
-        {
-        }
+}
 
-        virtual int call()
-        {
-            return 0;
-        }
-};
+MapUpdater::~MapUpdater()
+{
+    deactivate();
+}
 
-class WDBThreadEndReq1 : public ACE_Method_Request
+int MapUpdater::activate(size_t num_threads)
 {
-    public:
+    if (activated() || num_threads < 1)
+        return -1;
 
-        WDBThreadEndReq1()
-        {
-        }
+    for (size_t i = 0; i < num_threads; ++i)
+        m_workers.push_back(new Worker());
 
-        virtual int call()
-        {
-            return 0;
-        }
-};
+    m_nextWorkerIndex = 0;
+    m_stopping = false;
+
+    if (ACE_Task_Base::activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, int(num_threads)) == -1)
+    {
+        for (size_t i = 0; i < m_workers.size(); ++i)
+            delete m_workers[i];
+        m_workers.clear();
+        return -1;
+    }
 
-class MapUpdateRequest : public ACE_Method_Request
+    m_activated = true;
+    return 0;
+}
+
+int MapUpdater::deactivate()
 {
-    private:
+    if (!activated())
+        return -1;
 
-        Map& m_map;
-        MapUpdater& m_updater;
-        ACE_UINT32 m_diff;
+    wait();
 
-    public:
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+        m_stopping = true;
+        m_workCondition.broadcast();
+    }
 
-        MapUpdateRequest(Map& m, MapUpdater& u, ACE_UINT32 d)
-            : m_map(m), m_updater(u), m_diff(d)
-        {
-        }
+    ACE_Task_Base::wait();
+    m_activated = false;
 
-        virtual int call()
-        {
-            m_map.Update (m_diff);
-            m_updater.update_finished();
-            return 0;
-        }
-};
+    for (size_t i = 0; i < m_workers.size(); ++i)
+        delete m_workers[i];
+    m_workers.clear();
 
-MapUpdater::MapUpdater():
-m_executor(), m_mutex(), m_condition(m_mutex), pending_requests(0)
+    return 0;
+}
+
+int MapUpdater::wait()
 {
+    TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+
+    while (pending_requests.value() > 0)
+        m_finishedCondition.wait();
+
+    return 0;
 }
 
-MapUpdater::~MapUpdater()
+int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
 {
-    deactivate();
+    if (m_workers.empty())
+    {
+        ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Map Update")));
+        return -1;
+    }
+
+    UpdateRequest request;
+    request.map = &map;
+    request.diff = diff;
+    request.cost = std::max<uint32>(map.GetAverageUpdateTime(), 1);
+    request.sendOnly = false;
+
+    _queueRequest(request);
+    return 0;
 }
 
-int MapUpdater::activate(size_t num_threads)
+int MapUpdater::schedule_send(Map& map)
 {
-    return m_executor.start((int)num_threads, new WDBThreadStartReq1, new WDBThreadEndReq1);
+    if (m_workers.empty())
+        return -1;
+
+    UpdateRequest request;
+    request.map = &map;
+    request.diff = 0;
+    request.cost = std::max<uint32>(map.GetAverageUpdateTime(), 1);
+    request.sendOnly = true;
+
+    _queueRequest(request);
+    return 0;
 }
 
-int MapUpdater::deactivate()
+void MapUpdater::_queueRequest(UpdateRequest const& request)
 {
-    wait();
+    ++pending_requests;
+    ++m_queuedRequests;
+
+    // hand the request to the least loaded worker, keeping its queue sorted by cost
+    Worker* target = NULL;
+    uint32 targetCost = 0;
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, m_workers[i]->lock);
+        if (!target || m_workers[i]->queuedCost < targetCost)
+        {
+            target = m_workers[i];
+            targetCost = target->queuedCost;
+        }
+    }
+
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, target->lock);
+        RequestQueue::iterator itr = target->requests.begin();
+        while (itr != target->requests.end() && itr->cost >= request.cost)
+            ++itr;
+        target->requests.insert(itr, request);
+        target->queuedCost += request.cost;
+    }
 
-    return m_executor.deactivate();
+    if (m_idleWorkers.value() > 0)
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+        m_workCondition.signal();
+    }
 }
 
-int MapUpdater::wait()
+bool MapUpdater::activated()
 {
-    TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+    return m_activated;
+}
+
+int MapUpdater::svc()
+{
+    size_t const index = size_t((++m_nextWorkerIndex) - 1);
+
+    for (;;)
+    {
+        UpdateRequest request;
+        if (_popRequest(index, request) || _stealRequest(index, request))
+        {
+            --m_queuedRequests;
+            _runRequest(request);
+            continue;
+        }
+
+        TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
 
-    while (pending_requests > 0)
-        m_condition.wait();
+        if (m_stopping)
+            break;
+
+        ++m_idleWorkers;
+        if (m_queuedRequests.value() == 0)
+            m_workCondition.wait();
+        --m_idleWorkers;
+    }
 
     return 0;
 }
 
-int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
+bool MapUpdater::_popRequest(size_t index, UpdateRequest& request)
 {
-    TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+    Worker* worker = m_workers[index];
+    TRINITY_GUARD(ACE_Thread_Mutex, worker->lock);
 
-    ++pending_requests;
+    if (worker->requests.empty())
+        return false;
 
-    if (m_executor.execute(new MapUpdateRequest(map, *this, diff)) == -1)
+    request = worker->requests.front();
+    worker->requests.pop_front();
+    worker->queuedCost -= request.cost;
+    return true;
+}
+
+bool MapUpdater::_stealRequest(size_t index, UpdateRequest& request)
+{
+    for (size_t i = 1; i < m_workers.size(); ++i)
     {
-        ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Map Update")));
+        Worker* victim = m_workers[(index + i) % m_workers.size()];
+        TRINITY_GUARD(ACE_Thread_Mutex, victim->lock);
 
-        --pending_requests;
-        return -1;
+        if (victim->requests.empty())
+            continue;
+
+        request = victim->requests.back();
+        victim->requests.pop_back();
+        victim->queuedCost -= request.cost;
+        return true;
     }
 
-    return 0;
+    return false;
 }
 
-bool MapUpdater::activated()
+void MapUpdater::_runRequest(UpdateRequest const& request)
 {
-    return m_executor.activated();
+    if (request.sendOnly)
+    {
+        request.map->SendObjectUpdates();
+        update_finished();
+        return;
+    }
+
+    uint32 startTime = getMSTime();
+
+    request.map->Update(request.diff);
+
+    request.map->RecordUpdateTime(GetMSTimeDiffToNow(startTime));
+
+    update_finished();
 }
 
 void MapUpdater::update_finished()
 {
-    TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+    long remaining = --pending_requests;
 
-    if (pending_requests == 0)
+    if (remaining < 0)
     {
         ACE_ERROR((LM_ERROR, ACE_TEXT("(%t)\n"), ACE_TEXT("MapUpdater::update_finished BUG, report to devs")));
+        pending_requests = 0;
         return;
     }
 
-    --pending_requests;
-
-    m_condition.broadcast();
+    // only the last finished request wakes the world thread
+    if (remaining == 0)
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+        m_finishedCondition.broadcast();
+    }
 }
@@ -1,24 +1,30 @@
 #ifndef _MAP_UPDATER_H_INCLUDED
 #define _MAP_UPDATER_H_INCLUDED
 
+#include <ace/Task.h>
+#include <ace/Atomic_Op.h>
 #include <ace/Thread_Mutex.h>
 #include <ace/Condition_Thread_Mutex.h>
 
-#include "DelayExecutor.h"
+#include <deque>
+#include <vector>
+
+#include "Define.h"
 
 class Map;
 
-class MapUpdater
+class MapUpdater : protected ACE_Task_Base
 {
     public:
 
         MapUpdater();
         virtual ~MapUpdater();
 
-        friend class MapUpdateRequest;
-
         int schedule_update(Map& map, ACE_UINT32 diff);
 
+        // sends the object updates collected by the map, see Map::SendObjectUpdates
+        int schedule_send(Map& map);
+
         int wait();
 
         int activate(size_t num_threads);
@@ -27,14 +33,52 @@ class MapUpdater
 
         bool activated();
 
+        virtual int svc();
+
     private:
 
-        DelayExecutor m_executor;
-        ACE_Thread_Mutex m_mutex;
-        ACE_Condition_Thread_Mutex m_condition;
-        size_t pending_requests;
+        struct UpdateRequest
+        {
+            Map* map;
+            ACE_UINT32 diff;
+            uint32 cost;                                    // update time of the map in the previous ticks
+            bool sendOnly;                                  // only send the object updates of the map
+        };
+
+        typedef std::deque<UpdateRequest> RequestQueue;
+
+        // requests are kept sorted by cost, the owner thread takes the most expensive
+        // one from the front while idle threads steal the cheapest ones from the back
+        struct Worker
+        {
+            Worker() : queuedCost(0) { }
+
+            ACE_Thread_Mutex lock;
+            RequestQueue requests;
+            uint32 queuedCost;
+        };
+
+        typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicCounter;
+
+        void _queueRequest(UpdateRequest const& request);
+        bool _popRequest(size_t index, UpdateRequest& request);
+        bool _stealRequest(size_t index, UpdateRequest& request);
+        void _runRequest(UpdateRequest const& request);
 
         void update_finished();
+
+        std::vector<Worker*> m_workers;
+        AtomicCounter m_nextWorkerIndex;
+
+        AtomicCounter pending_requests;                     // scheduled and not finished yet
+        AtomicCounter m_queuedRequests;                     // scheduled and not picked by a worker yet
+        AtomicCounter m_idleWorkers;
+
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_workCondition;         // idle workers sleep here
+        ACE_Condition_Thread_Mutex m_finishedCondition;     // wait() sleeps here
+        bool m_activated;
+        bool m_stopping;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
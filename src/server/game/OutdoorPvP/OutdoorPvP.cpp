@@ -147,7 +147,7 @@ bool OPvPCapturePoint::DelCreature(uint32 type)
         return false;
     }
 
-    Creature* cr = HashMapHolder<Creature>::Find(m_Creatures[type]);
+    Creature* cr = ObjectAccessor::FindSpawnedCreature(m_Creatures[type]);
     if (!cr)
     {
         // can happen when closing the core
@@ -183,7 +183,7 @@ bool OPvPCapturePoint::DelObject(uint32 type)
     if (!m_Objects[type])
         return false;
 
-    GameObject* obj = HashMapHolder<GameObject>::Find(m_Objects[type]);
+    GameObject* obj = ObjectAccessor::FindSpawnedGameObject(m_Objects[type]);
     if (!obj)
     {
         m_Objects[type] = 0;
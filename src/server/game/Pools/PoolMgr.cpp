@@ -221,8 +221,10 @@ void PoolGroup<Creature>::Despawn1Object(uint32 guid)
     {
         sObjectMgr->RemoveCreatureFromGrid(guid, data);
 
-        if (Creature* creature = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(guid, data->id, HIGHGUID_UNIT), (Creature*)NULL))
-            creature->AddObjectToRemoveList();
+        std::vector<Creature*> creatures;
+        ObjectAccessor::FindSpawnedCreatures(MAKE_NEW_GUID(guid, data->id, HIGHGUID_UNIT), creatures);
+        for (std::vector<Creature*>::const_iterator itr = creatures.begin(); itr != creatures.end(); ++itr)
+            (*itr)->AddObjectToRemoveList();
     }
 }
 
@@ -234,8 +236,10 @@ void PoolGroup<GameObject>::Despawn1Object(uint32 guid)
     {
         sObjectMgr->RemoveGameobjectFromGrid(guid, data);
 
-        if (GameObject* pGameobject = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(guid, data->id, HIGHGUID_GAMEOBJECT), (GameObject*)NULL))
-            pGameobject->AddObjectToRemoveList();
+        std::vector<GameObject*> gameobjects;
+        ObjectAccessor::FindSpawnedGameObjects(MAKE_NEW_GUID(guid, data->id, HIGHGUID_GAMEOBJECT), gameobjects);
+        for (std::vector<GameObject*>::const_iterator itr = gameobjects.begin(); itr != gameobjects.end(); ++itr)
+            (*itr)->AddObjectToRemoveList();
     }
 }
 
@@ -510,7 +514,7 @@ template <>
 void PoolGroup<Creature>::ReSpawn1Object(PoolObject* obj)
 {
     if (CreatureData const* data = sObjectMgr->GetCreatureData(obj->guid))
-        if (Creature* creature = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(obj->guid, data->id, HIGHGUID_UNIT), (Creature*)NULL))
+        if (Creature* creature = ObjectAccessor::FindSpawnedCreature(MAKE_NEW_GUID(obj->guid, data->id, HIGHGUID_UNIT)))
             creature->GetMap()->AddToMap(creature);
 }
 
@@ -519,7 +523,7 @@ template <>
 void PoolGroup<GameObject>::ReSpawn1Object(PoolObject* obj)
 {
     if (GameObjectData const* data = sObjectMgr->GetGOData(obj->guid))
-        if (GameObject* pGameobject = ObjectAccessor::GetObjectInWorld(MAKE_NEW_GUID(obj->guid, data->id, HIGHGUID_GAMEOBJECT), (GameObject*)NULL))
+        if (GameObject* pGameobject = ObjectAccessor::FindSpawnedGameObject(MAKE_NEW_GUID(obj->guid, data->id, HIGHGUID_GAMEOBJECT)))
             pGameobject->GetMap()->AddToMap(pGameobject);
 }
 
@@ -296,6 +296,13 @@ void ScriptMgr::Unload()
     SCR_CLEAR(UnitScript);
 
     #undef SCR_CLEAR
+
+    for (uint8 i = 0; i < MAX_PACKET_HOOK_TYPES; ++i)
+    {
+        _packetHooks[i].clear();
+        _allOpcodesPacketHooks[i].clear();
+        _packetHookMask[i].clear();
+    }
 }
 
 void ScriptMgr::LoadDatabase()
@@ -475,27 +482,80 @@ void ScriptMgr::OnSocketClose(WorldSocket* socket, bool wasNew)
     FOREACH_SCRIPT(ServerScript)->OnSocketClose(socket, wasNew);
 }
 
-void ScriptMgr::OnPacketReceive(WorldSocket* socket, WorldPacket packet)
+void ScriptMgr::OnPacketReceive(WorldSocket* socket, WorldPacket const& packet)
 {
     ASSERT(socket);
 
-    FOREACH_SCRIPT(ServerScript)->OnPacketReceive(socket, packet);
+    CallPacketHooks(PACKET_HOOK_RECEIVE, socket, packet);
 }
 
-void ScriptMgr::OnPacketSend(WorldSocket* socket, WorldPacket packet)
+void ScriptMgr::OnPacketSend(WorldSocket* socket, WorldPacket const& packet)
 {
     ASSERT(socket);
 
-    FOREACH_SCRIPT(ServerScript)->OnPacketSend(socket, packet);
+    CallPacketHooks(PACKET_HOOK_SEND, socket, packet);
 }
 
-void ScriptMgr::OnUnknownPacketReceive(WorldSocket* socket, WorldPacket packet)
+void ScriptMgr::OnUnknownPacketReceive(WorldSocket* socket, WorldPacket& packet)
 {
     ASSERT(socket);
 
     FOREACH_SCRIPT(ServerScript)->OnUnknownPacketReceive(socket, packet);
 }
 
+void ScriptMgr::AddPacketHook(ServerScript* script, PacketHookType type, uint16 opcode)
+{
+    ASSERT(script && type < MAX_PACKET_HOOK_TYPES);
+
+    std::vector<bool>& mask = _packetHookMask[type];
+    if (mask.size() <= opcode)
+        mask.resize(opcode + 1, false);
+    mask[opcode] = true;
+
+    _packetHooks[type][opcode].push_back(script);
+}
+
+void ScriptMgr::AddPacketHookForAllOpcodes(ServerScript* script, PacketHookType type)
+{
+    ASSERT(script && type < MAX_PACKET_HOOK_TYPES);
+
+    _allOpcodesPacketHooks[type].push_back(script);
+}
+
+void ScriptMgr::CallPacketHooks(PacketHookType type, WorldSocket* socket, WorldPacket const& packet)
+{
+    // checked for every packet in both directions, so keep the common case of no subscriber cheap
+    PacketHookList const& allOpcodes = _allOpcodesPacketHooks[type];
+    std::vector<bool> const& mask = _packetHookMask[type];
+    uint16 opcode = uint16(packet.GetOpcode());
+    bool subscribed = opcode < mask.size() && mask[opcode];
+    if (!subscribed && allOpcodes.empty())
+        return;
+
+    for (PacketHookList::const_iterator itr = allOpcodes.begin(); itr != allOpcodes.end(); ++itr)
+    {
+        if (type == PACKET_HOOK_RECEIVE)
+            (*itr)->OnPacketReceive(socket, packet);
+        else
+            (*itr)->OnPacketSend(socket, packet);
+    }
+
+    if (!subscribed)
+        return;
+
+    PacketHookMap::const_iterator hooks = _packetHooks[type].find(opcode);
+    if (hooks == _packetHooks[type].end())
+        return;
+
+    for (PacketHookList::const_iterator itr = hooks->second.begin(); itr != hooks->second.end(); ++itr)
+    {
+        if (type == PACKET_HOOK_RECEIVE)
+            (*itr)->OnPacketReceive(socket, packet);
+        else
+            (*itr)->OnPacketSend(socket, packet);
+    }
+}
+
 void ScriptMgr::OnOpenStateChange(bool open)
 {
     FOREACH_SCRIPT(WorldScript)->OnOpenStateChange(open);
@@ -1458,6 +1518,16 @@ ServerScript::ServerScript(const char* name)
     ScriptRegistry<ServerScript>::AddScript(this);
 }
 
+void ServerScript::RegisterPacketHook(PacketHookType type, uint16 opcode)
+{
+    sScriptMgr->AddPacketHook(this, type, opcode);
+}
+
+void ServerScript::RegisterPacketHookForAllOpcodes(PacketHookType type)
+{
+    sScriptMgr->AddPacketHookForAllOpcodes(this, type);
+}
+
 WorldScript::WorldScript(const char* name)
     : ScriptObject(name)
 {
@@ -204,12 +204,25 @@ class SpellScriptLoader : public ScriptObject
         virtual AuraScript* GetAuraScript() const { return NULL; }
 };
 
+enum PacketHookType
+{
+    PACKET_HOOK_RECEIVE,
+    PACKET_HOOK_SEND,
+
+    MAX_PACKET_HOOK_TYPES
+};
+
 class ServerScript : public ScriptObject
 {
     protected:
 
         ServerScript(const char* name);
 
+        // Subscribes the script to OnPacketReceive/OnPacketSend for the given opcode, call these from the constructor.
+        // Packets are only passed to the scripts subscribed to their opcode.
+        void RegisterPacketHook(PacketHookType type, uint16 opcode);
+        void RegisterPacketHookForAllOpcodes(PacketHookType type);
+
     public:
 
         // Called when reactive socket I/O is started (WorldSocketMgr).
@@ -225,13 +238,13 @@ class ServerScript : public ScriptObject
         // being open; it is not.
         virtual void OnSocketClose(WorldSocket* /*socket*/, bool /*wasNew*/) { }
 
-        // Called when a packet is sent to a client. The packet object is a copy of the original packet, so reading
-        // and modifying it is safe.
-        virtual void OnPacketSend(WorldSocket* /*socket*/, WorldPacket& /*packet*/) { }
+        // Called when a packet with a subscribed opcode is sent to a client. The packet is the original one, use
+        // ByteBuffer::read(pos) to look at it or copy it before reading it as a stream.
+        virtual void OnPacketSend(WorldSocket* /*socket*/, WorldPacket const& /*packet*/) { }
 
-        // Called when a (valid) packet is received by a client. The packet object is a copy of the original packet, so
-        // reading and modifying it is safe.
-        virtual void OnPacketReceive(WorldSocket* /*socket*/, WorldPacket& /*packet*/) { }
+        // Called when a (valid) packet with a subscribed opcode is received by a client, before it is handled. The
+        // packet is the original one, use ByteBuffer::read(pos) to look at it or copy it before reading it as a stream.
+        virtual void OnPacketReceive(WorldSocket* /*socket*/, WorldPacket const& /*packet*/) { }
 
         // Called when an invalid (unknown opcode) packet is received by a client. The packet is a reference to the orignal
         // packet; not a copy. This allows you to actually handle unknown packets (for whatever purpose).
@@ -871,9 +884,11 @@ class ScriptMgr
         void OnNetworkStop();
         void OnSocketOpen(WorldSocket* socket);
         void OnSocketClose(WorldSocket* socket, bool wasNew);
-        void OnPacketReceive(WorldSocket* socket, WorldPacket packet);
-        void OnPacketSend(WorldSocket* socket, WorldPacket packet);
-        void OnUnknownPacketReceive(WorldSocket* socket, WorldPacket packet);
+        void OnPacketReceive(WorldSocket* socket, WorldPacket const& packet);
+        void OnPacketSend(WorldSocket* socket, WorldPacket const& packet);
+        void OnUnknownPacketReceive(WorldSocket* socket, WorldPacket& packet);
+        void AddPacketHook(ServerScript* script, PacketHookType type, uint16 opcode);
+        void AddPacketHookForAllOpcodes(ServerScript* script, PacketHookType type);
 
     public: /* WorldScript */
 
@@ -1074,8 +1089,17 @@ class ScriptMgr
 
     private:
 
+        void CallPacketHooks(PacketHookType type, WorldSocket* socket, WorldPacket const& packet);
+
         uint32 _scriptCount;
 
+        // subscribed ServerScripts per opcode, filled at startup like the script registries
+        typedef std::vector<ServerScript*> PacketHookList;
+        typedef UNORDERED_MAP<uint16, PacketHookList> PacketHookMap;
+        PacketHookMap _packetHooks[MAX_PACKET_HOOK_TYPES];
+        PacketHookList _allOpcodesPacketHooks[MAX_PACKET_HOOK_TYPES];
+        std::vector<bool> _packetHookMask[MAX_PACKET_HOOK_TYPES];
+
         //atomic op counter for active scripts amount
         ACE_Atomic_Op<ACE_Thread_Mutex, long> _scheduledScripts;
 };
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PacketPool.h"
+#include "WorldPacket.h"
+#include <ace/Message_Block.h>
+
+// capacity of the packets in each size class, clients send at most 10240 bytes per packet
+static size_t const PacketSizeClasses[PACKET_POOL_SIZE_CLASSES] = { 128, 512, 2048, 10240 };
+
+// packets/blocks kept by one thread, and moved from/to the depot at once
+static size_t const PacketCacheSize = 64;
+static size_t const PacketBatchSize = 32;
+static size_t const PacketDepotSize = 1024;
+
+static size_t const BlockCacheSize = 4;
+static size_t const BlockBatchSize = 2;
+static size_t const BlockDepotSize = 32;
+
+size_t const PacketPool::BlockSize;
+
+PacketPool::PacketPool()
+{
+}
+
+PacketPool::~PacketPool()
+{
+    for (uint8 i = 0; i < PACKET_POOL_SIZE_CLASSES; ++i)
+        for (PacketList::iterator itr = _packetDepot[i].begin(); itr != _packetDepot[i].end(); ++itr)
+            delete *itr;
+
+    for (BlockList::iterator itr = _blockDepot.begin(); itr != _blockDepot.end(); ++itr)
+        (*itr)->release();
+}
+
+PacketPool::ThreadCache::~ThreadCache()
+{
+    for (uint8 i = 0; i < PACKET_POOL_SIZE_CLASSES; ++i)
+        for (PacketList::iterator itr = Packets[i].begin(); itr != Packets[i].end(); ++itr)
+            delete *itr;
+
+    for (BlockList::iterator itr = Blocks.begin(); itr != Blocks.end(); ++itr)
+        (*itr)->release();
+}
+
+void PacketPool::Counters::OnAcquire(bool reused)
+{
+    ++Acquired;
+    if (reused)
+        ++Reused;
+
+    long inUse = ++InUse;
+    if (inUse > HighWaterMark)
+        HighWaterMark = inUse;
+}
+
+void PacketPool::Counters::Get(Stats& stats) const
+{
+    stats.Acquired = Acquired.value();
+    stats.Reused = Reused.value();
+    stats.InUse = InUse.value();
+    stats.HighWaterMark = HighWaterMark;
+}
+
+int8 PacketPool::GetSizeClass(size_t size)
+{
+    for (uint8 i = 0; i < PACKET_POOL_SIZE_CLASSES; ++i)
+        if (size <= PacketSizeClasses[i])
+            return int8(i);
+
+    return -1;
+}
+
+template<class T>
+bool PacketPool::TakeFromDepot(std::vector<T*>& cache, std::vector<T*>& depot, size_t batch)
+{
+    size_t count = std::min(batch, depot.size());
+    cache.insert(cache.end(), depot.end() - count, depot.end());
+    depot.resize(depot.size() - count);
+    return count > 0;
+}
+
+template<class T>
+void PacketPool::GiveToDepot(std::vector<T*>& cache, std::vector<T*>& depot, size_t batch, size_t depotLimit)
+{
+    size_t count = std::min(std::min(batch, cache.size()), depotLimit - std::min(depotLimit, depot.size()));
+    depot.insert(depot.end(), cache.end() - count, cache.end());
+    cache.resize(cache.size() - count);
+}
+
+WorldPacket* PacketPool::AcquirePacket(Opcodes opcode, size_t size)
+{
+    WorldPacket* packet = NULL;
+
+    int8 sizeClass = GetSizeClass(size);
+    if (sizeClass >= 0)
+    {
+        PacketList& cache = _threadCache->Packets[sizeClass];
+        if (cache.empty())
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, _depotLock);
+            TakeFromDepot(cache, _packetDepot[sizeClass], PacketBatchSize);
+        }
+
+        if (!cache.empty())
+        {
+            packet = cache.back();
+            cache.pop_back();
+            packet->Initialize(opcode, 0);
+            packet->ResetBitPos();
+        }
+    }
+
+    _packetCounters.OnAcquire(packet != NULL);
+
+    if (!packet)
+        packet = new WorldPacket(opcode, sizeClass >= 0 ? PacketSizeClasses[sizeClass] : size);
+
+    if (size > 0)
+        packet->resize(size);
+
+    return packet;
+}
+
+void PacketPool::ReleasePacket(WorldPacket* packet)
+{
+    if (!packet)
+        return;
+
+    _packetCounters.OnRelease();
+
+    // pick the largest class the packet can still hold, handlers may have grown the storage
+    int8 sizeClass = -1;
+    for (uint8 i = 0; i < PACKET_POOL_SIZE_CLASSES; ++i)
+        if (packet->capacity() >= PacketSizeClasses[i])
+            sizeClass = int8(i);
+
+    if (sizeClass < 0 || packet->capacity() > PacketSizeClasses[PACKET_POOL_SIZE_CLASSES - 1] * 2)
+    {
+        delete packet;
+        return;
+    }
+
+    PacketList& cache = _threadCache->Packets[sizeClass];
+    cache.push_back(packet);
+
+    if (cache.size() > PacketCacheSize)
+    {
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, _depotLock);
+            GiveToDepot(cache, _packetDepot[sizeClass], PacketBatchSize, PacketDepotSize);
+        }
+
+        // depot is full as well
+        while (cache.size() > PacketCacheSize)
+        {
+            delete cache.back();
+            cache.pop_back();
+        }
+    }
+}
+
+ACE_Message_Block* PacketPool::AcquireBlock(size_t size)
+{
+    ACE_Message_Block* block = NULL;
+
+    if (size <= BlockSize)
+    {
+        BlockList& cache = _threadCache->Blocks;
+        if (cache.empty())
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, _depotLock);
+            TakeFromDepot(cache, _blockDepot, BlockBatchSize);
+        }
+
+        if (!cache.empty())
+        {
+            block = cache.back();
+            cache.pop_back();
+            block->reset();
+        }
+    }
+
+    _blockCounters.OnAcquire(block != NULL);
+
+    if (!block)
+        block = new ACE_Message_Block(std::max(size, BlockSize));
+
+    return block;
+}
+
+void PacketPool::ReleaseBlock(ACE_Message_Block* block)
+{
+    if (!block)
+        return;
+
+    _blockCounters.OnRelease();
+
+    if (block->size() != BlockSize)
+    {
+        block->release();
+        return;
+    }
+
+    BlockList& cache = _threadCache->Blocks;
+    cache.push_back(block);
+
+    if (cache.size() > BlockCacheSize)
+    {
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, _depotLock);
+            GiveToDepot(cache, _blockDepot, BlockBatchSize, BlockDepotSize);
+        }
+
+        while (cache.size() > BlockCacheSize)
+        {
+            cache.back()->release();
+            cache.pop_back();
+        }
+    }
+}
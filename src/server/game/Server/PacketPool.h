@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PACKETPOOL_H
+#define TRINITY_PACKETPOOL_H
+
+#include "Common.h"
+#include "Opcodes.h"
+#include <ace/Singleton.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/TSS_T.h>
+
+class ACE_Message_Block;
+class WorldPacket;
+
+#define PACKET_POOL_SIZE_CLASSES 4
+
+// Recycles received packets and the output blocks of WorldSocket. Both are allocated by one thread
+// and freed by another (reactor -> map/world threads for packets, the other way round for blocks),
+// so every thread keeps a small cache per size class and exchanges batches with a shared depot.
+class PacketPool
+{
+    friend class ACE_Singleton<PacketPool, ACE_Thread_Mutex>;
+
+    private:
+        PacketPool();
+        ~PacketPool();
+
+    public:
+        // size of the pooled output blocks, larger ones are allocated directly
+        static size_t const BlockSize = 65536;
+
+        struct Stats
+        {
+            long Acquired;
+            long Reused;
+            long InUse;
+            long HighWaterMark;
+        };
+
+        // packet with its storage resized to size, has to be freed with ReleasePacket or delete
+        WorldPacket* AcquirePacket(Opcodes opcode, size_t size);
+        void ReleasePacket(WorldPacket* packet);
+
+        ACE_Message_Block* AcquireBlock(size_t size);
+        void ReleaseBlock(ACE_Message_Block* block);
+
+        void GetPacketStats(Stats& stats) const { _packetCounters.Get(stats); }
+        void GetBlockStats(Stats& stats) const { _blockCounters.Get(stats); }
+
+    private:
+        typedef std::vector<WorldPacket*> PacketList;
+        typedef std::vector<ACE_Message_Block*> BlockList;
+
+        struct ThreadCache
+        {
+            ~ThreadCache();
+
+            PacketList Packets[PACKET_POOL_SIZE_CLASSES];
+            BlockList Blocks;
+        };
+
+        struct Counters
+        {
+            Counters() : Acquired(0), Reused(0), InUse(0), HighWaterMark(0) { }
+
+            void OnAcquire(bool reused);
+            void OnRelease() { --InUse; }
+            void Get(Stats& stats) const;
+
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> Acquired;
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> Reused;
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> InUse;
+            long HighWaterMark;                             // updated without lock, only informative
+        };
+
+        template<class T>
+        static bool TakeFromDepot(std::vector<T*>& cache, std::vector<T*>& depot, size_t batch);
+        template<class T>
+        static void GiveToDepot(std::vector<T*>& cache, std::vector<T*>& depot, size_t batch, size_t depotLimit);
+
+        static int8 GetSizeClass(size_t size);
+
+        ACE_TSS<ThreadCache> _threadCache;
+
+        ACE_Thread_Mutex _depotLock;
+        PacketList _packetDepot[PACKET_POOL_SIZE_CLASSES];
+        BlockList _blockDepot;
+
+        Counters _packetCounters;
+        Counters _blockCounters;
+};
+
+#define sPacketPool ACE_Singleton<PacketPool, ACE_Thread_Mutex>::instance()
+
+// Returns a received packet to the pool unless it was handed over with release()
+class PacketPoolGuard
+{
+    public:
+        explicit PacketPoolGuard(WorldPacket* packet) : _packet(packet) { }
+        ~PacketPoolGuard() { sPacketPool->ReleasePacket(_packet); }
+
+        WorldPacket* release()
+        {
+            WorldPacket* packet = _packet;
+            _packet = NULL;
+            return packet;
+        }
+
+    private:
+        WorldPacket* _packet;
+};
+#endif
@@ -104,3 +104,59 @@ void WorldPacket::Compress(void* dst, uint32 *dst_size, const void* src, int src
 
     *dst_size -= _compressionStream->avail_out;
 }
+
+//! Ends the history of a session compression stream, so that data compressed by BroadcastPacket can follow it
+bool WorldPacket::ResetCompressionHistory(z_stream* compressionStream)
+{
+    // the zlib header of the stream has to be sent by the session stream itself
+    if (!compressionStream->total_out)
+        return false;
+
+    // A full flush keeps the next packets of the session from referring to data before it, which the client
+    // no longer has at the same distance once the broadcast data is inflated in between. The output is an
+    // empty stored block, it does not have to reach the client.
+    uint8 flushed[32];
+    compressionStream->next_out = flushed;
+    compressionStream->avail_out = sizeof(flushed);
+    compressionStream->next_in = NULL;
+    compressionStream->avail_in = 0;
+
+    // Z_BUF_ERROR without pending input only means that the previous call was a full flush already
+    int32 z_res = deflate(compressionStream, Z_FULL_FLUSH);
+    if ((z_res != Z_OK && z_res != Z_BUF_ERROR) || compressionStream->avail_out == 0)
+    {
+        sLog->outError(LOG_FILTER_NETWORKIO, "Can't reset compression history (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+        return false;
+    }
+
+    return true;
+}
+
+WorldPacket const* BroadcastPacket::GetCompressedPacket() const
+{
+    if (_packet.size() <= PACKET_COMPRESSION_THRESHOLD)
+        return NULL;
+
+    if (!_compressionDone)
+    {
+        _compressionDone = true;
+
+        // raw deflate, the receivers have already sent the zlib header with their own streams
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        int32 z_res = deflateInit2(&stream, sWorld->getIntConfig(CONFIG_COMPRESSION), Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        if (z_res != Z_OK)
+        {
+            sLog->outError(LOG_FILTER_NETWORKIO, "Can't initialize broadcast packet compression (zlib: deflateInit2) Error code: %i (%s)", z_res, zError(z_res));
+            return NULL;
+        }
+
+        _compressedPacket.Compress(&stream, &_packet);
+        deflateEnd(&stream);
+    }
+
+    if (!(_compressedPacket.GetOpcode() & COMPRESSED_OPCODE_MASK) || _compressedPacket.GetOpcode() == UNKNOWN_OPCODE)
+        return NULL;
+
+    return &_compressedPacket;
+}
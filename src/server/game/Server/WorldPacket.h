@@ -25,6 +25,9 @@
 
 struct z_stream_s;
 
+// packets larger than this are compressed before being sent
+#define PACKET_COMPRESSION_THRESHOLD 0x400
+
 class WorldPacket : public ByteBuffer
 {
     public:
@@ -52,11 +55,30 @@ class WorldPacket : public ByteBuffer
         void SetOpcode(Opcodes opcode) { m_opcode = opcode; }
         void Compress(z_stream_s* compressionStream);
         void Compress(z_stream_s* compressionStream, WorldPacket const* source);
+        static bool ResetCompressionHistory(z_stream_s* compressionStream);
 
     protected:
         Opcodes m_opcode;
         void Compress(void* dst, uint32 *dst_size, const void* src, int src_size);
         z_stream_s* _compressionStream;
 };
+
+// A packet sent to many sessions. When it is large enough it is deflated only once, with a stream of its own,
+// and the same data is appended to the compression stream of every receiver (see WorldSocket::SendPacket).
+class BroadcastPacket
+{
+    public:
+        explicit BroadcastPacket(WorldPacket const& packet) : _packet(packet), _compressionDone(false) { }
+
+        WorldPacket const& GetPacket() const { return _packet; }
+
+        // compressed on first use, NULL if the packet is too small or could not be compressed
+        WorldPacket const* GetCompressedPacket() const;
+
+    private:
+        WorldPacket const& _packet;
+        mutable WorldPacket _compressedPacket;
+        mutable bool _compressionDone;
+};
 #endif
 
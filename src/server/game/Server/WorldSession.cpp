@@ -46,6 +46,7 @@
 #include "Transport.h"
 #include "WardenWin.h"
 #include "WardenMac.h"
+#include "PacketPool.h"
 
 namespace {
 
@@ -166,7 +167,7 @@ WorldSession::~WorldSession()
     ///- empty incoming packet queue
     WorldPacket* packet = NULL;
     while (_recvQueue.next(packet))
-        delete packet;
+        sPacketPool->ReleasePacket(packet);
 
     LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());     // One-time query
 
@@ -204,6 +205,17 @@ uint32 WorldSession::GetGuidLow() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
+{
+    _SendPacket(packet, forced, NULL);
+}
+
+/// Send a packet which is sent to other sessions too, large packets are compressed only once for all of them
+void WorldSession::SendPacket(BroadcastPacket const& packet)
+{
+    _SendPacket(&packet.GetPacket(), false, &packet);
+}
+
+void WorldSession::_SendPacket(WorldPacket const* packet, bool forced, BroadcastPacket const* broadcast)
 {
     if (!m_Socket)
         return;
@@ -264,7 +276,7 @@ void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/
     }
 #endif                                                      // !TRINITY_DEBUG
 
-    if (m_Socket->SendPacket(*packet) == -1)
+    if ((broadcast ? m_Socket->SendPacket(*broadcast) : m_Socket->SendPacket(*packet)) == -1)
         m_Socket->CloseSocket();
 }
 
@@ -273,7 +285,7 @@ void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
     if (m_packetThrottler.MustDiscard(new_packet->GetOpcode(), GetAccountId(), GetRemoteAddress()))
     {
-        delete new_packet;
+        sPacketPool->ReleasePacket(new_packet);
         return;
     }
 
@@ -362,7 +374,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                     }
 					else if (_player->IsInWorld() && AntiDOS.EvaluateOpcode(*packet, currentTime))
                     {
-                        sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                        sScriptMgr->OnPacketReceive(m_Socket, *packet);
                         (this->*opHandle->Handler)(*packet);
                         LogUnprocessedTail(packet);
                     }
@@ -376,7 +388,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 					else if (AntiDOS.EvaluateOpcode(*packet, currentTime))
                     {
                         // not expected _player or must checked in packet hanlder
-                        sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                        sScriptMgr->OnPacketReceive(m_Socket, *packet);
                         (this->*opHandle->Handler)(*packet);
                         LogUnprocessedTail(packet);
                     }
@@ -388,7 +400,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                         LogUnexpectedOpcode(packet, "STATUS_TRANSFER", "the player is still in world");
 					else if (AntiDOS.EvaluateOpcode(*packet, currentTime))
                     {
-                        sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                        sScriptMgr->OnPacketReceive(m_Socket, *packet);
                         (this->*opHandle->Handler)(*packet);
                         LogUnprocessedTail(packet);
                     }
@@ -408,7 +420,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
 
 					if (AntiDOS.EvaluateOpcode(*packet, currentTime))
 					{
-						sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+						sScriptMgr->OnPacketReceive(m_Socket, *packet);
 						(this->*opHandle->Handler)(*packet);
 						LogUnprocessedTail(packet);
 						break;
@@ -440,7 +452,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
-            delete packet;
+            sPacketPool->ReleasePacket(packet);
     }
 
     if (m_Socket && !m_Socket->IsClosed() && _warden)
@@ -715,13 +727,6 @@ void WorldSession::SendAuthWaitQue(uint32 position)
     }
 }
 
-void WorldSession::LoadGlobalAccountData()
-{
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_ACCOUNT_DATA);
-    stmt->setUInt32(0, GetAccountId());
-    LoadAccountData(CharacterDatabase.Query(stmt), GLOBAL_CACHE_MASK);
-}
-
 void WorldSession::LoadAccountData(PreparedQueryResult result, uint32 mask)
 {
     for (uint32 i = 0; i < NUM_ACCOUNT_DATA_TYPES; ++i)
@@ -797,13 +802,11 @@ void WorldSession::SendAccountDataTimes(uint32 mask)
     SendPacket(&data);
 }
 
-void WorldSession::LoadTutorialsData()
+void WorldSession::LoadTutorialsData(PreparedQueryResult result)
 {
     memset(m_Tutorials, 0, sizeof(uint32) * MAX_ACCOUNT_TUTORIAL_VALUES);
 
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_TUTORIALS);
-    stmt->setUInt32(0, GetAccountId());
-    if (PreparedQueryResult result = CharacterDatabase.Query(stmt))
+    if (result)
         for (uint8 i = 0; i < MAX_ACCOUNT_TUTORIAL_VALUES; ++i)
             m_Tutorials[i] = (*result)[i].GetUInt32();
 
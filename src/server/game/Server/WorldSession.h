@@ -44,6 +44,7 @@ class Quest;
 class SpellCastTargets;
 class Unit;
 class Warden;
+class BroadcastPacket;
 class WorldPacket;
 class WorldSocket;
 struct AreaTableEntry;
@@ -240,6 +241,7 @@ class WorldSession
         bool IsAddonRegistered(const std::string& prefix) const;
 
         void SendPacket(WorldPacket const* packet, bool forced = false);
+        void SendPacket(BroadcastPacket const& packet);
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(uint32 string_id, ...);
         void SendPetNameInvalid(uint32 error, std::string const& name, DeclinedName *declinedName);
@@ -327,10 +329,9 @@ class WorldSession
         AccountData* GetAccountData(AccountDataType type) { return &m_accountData[type]; }
         void SetAccountData(AccountDataType type, time_t tm, std::string const& data);
         void SendAccountDataTimes(uint32 mask);
-        void LoadGlobalAccountData();
         void LoadAccountData(PreparedQueryResult result, uint32 mask);
 
-        void LoadTutorialsData();
+        void LoadTutorialsData(PreparedQueryResult result);
         void SendTutorialsData();
         void SaveTutorialsData(SQLTransaction& trans);
         uint32 GetTutorialInt(uint8 index) const { return m_Tutorials[index]; }
@@ -1051,6 +1052,8 @@ class WorldSession
         void LogUnexpectedOpcode(WorldPacket* packet, const char* status, const char *reason);
         void LogUnprocessedTail(WorldPacket* packet);
 
+        void _SendPacket(WorldPacket const* packet, bool forced, BroadcastPacket const* broadcast);
+
         // EnumData helpers
         bool CharCanLogin(uint32 lowGUID)
         {
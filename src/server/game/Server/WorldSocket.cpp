@@ -26,6 +26,8 @@
 #include <ace/OS_NS_string.h>
 #include <ace/Reactor.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/OS_NS_sys_socket.h>
+#include <ace/OS_NS_sys_uio.h>
 
 #include "WorldSocket.h"
 #include "Common.h"
@@ -43,6 +45,7 @@
 #include "WorldSocketMgr.h"
 #include "Log.h"
 #include "PacketLog.h"
+#include "PacketPool.h"
 #include "ScriptMgr.h"
 #include "AccountMgr.h"
 
@@ -99,25 +102,33 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+/// Upper limit of the data waiting in the output queue of a socket.
+#define WORLDSOCKET_OUT_QUEUE_LIMIT (8 * 1024 * 1024)
+
+/// Number of buffers sent with a single vectored write.
+#define WORLDSOCKET_MAX_IOV 64
+
 WorldSocket::WorldSocket (void): WorldHandler(),
-m_LastPingTime(ACE_Time_Value::zero), m_OverSpeedPings(0), m_Session(0),
+m_LastPingTime(ACE_Time_Value::zero), m_OverSpeedPings(0), m_Session(0), m_AuthSession(0),
 m_RecvWPct(0), m_RecvPct(), m_Header(sizeof (ClientPktHeader)),
-m_OutBuffer(0), m_OutBufferSize(65536), m_OutActive(false),
+m_OutBuffer(0), m_OutBufferSize(65536), m_OutQueueSize(0), m_OutActive(false),
 m_Seed(static_cast<uint32> (rand32())), m_forceCloseTime(0x8FFFFFFF)
 {
     reference_counting_policy().value (ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
-
-    msg_queue()->high_water_mark(8 * 1024 * 1024);
-    msg_queue()->low_water_mark(8 * 1024 * 1024);
 }
 
 WorldSocket::~WorldSocket (void)
 {
-    delete m_RecvWPct;
+    FinishAuthSession(false);
+
+    sPacketPool->ReleasePacket(m_RecvWPct);
 
     if (m_OutBuffer)
         m_OutBuffer->release();
 
+    for (OutQueue::iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end(); ++itr)
+        sPacketPool->ReleaseBlock(*itr);
+
     closing_ = true;
 
     peer().close();
@@ -153,6 +164,16 @@ const std::string& WorldSocket::GetRemoteAddress (void) const
 }
 
 int WorldSocket::SendPacket(WorldPacket const& pct)
+{
+    return SendPacket(pct, NULL);
+}
+
+int WorldSocket::SendPacket(BroadcastPacket const& packet)
+{
+    return SendPacket(packet.GetPacket(), &packet);
+}
+
+int WorldSocket::SendPacket(WorldPacket const& pct, BroadcastPacket const* broadcast)
 {
     ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
 
@@ -167,10 +188,17 @@ int WorldSocket::SendPacket(WorldPacket const& pct)
 
     // Empty buffer used in case packet should be compressed
     WorldPacket buff;
-    if (m_Session && pkt->size() > 0x400)
+    if (m_Session && pkt->size() > PACKET_COMPRESSION_THRESHOLD)
     {
-        buff.Compress(m_Session->GetCompressionStream(), pkt);
-        pkt = &buff;
+        // data compressed once for all receivers of a broadcast can continue our stream after a history reset
+        WorldPacket const* compressed = broadcast ? broadcast->GetCompressedPacket() : NULL;
+        if (compressed && WorldPacket::ResetCompressionHistory(m_Session->GetCompressionStream()))
+            pkt = compressed;
+        else
+        {
+            buff.Compress(m_Session->GetCompressionStream(), pkt);
+            pkt = &buff;
+        }
     }
 
     if (m_Session)
@@ -181,7 +209,7 @@ int WorldSocket::SendPacket(WorldPacket const& pct)
     ServerPktHeader header(pkt->size()+2, pkt->GetOpcode());
     m_Crypt.EncryptSend ((uint8*)header.header, header.getHeaderLength());
 
-    if (m_OutBuffer->space() >= pkt->size() + header.getHeaderLength() && msg_queue()->is_empty())
+    if (m_OutBuffer->space() >= pkt->size() + header.getHeaderLength() && m_OutQueue.empty())
     {
         // Put the packet on the buffer.
         if (m_OutBuffer->copy((char*) header.header, header.getHeaderLength()) == -1)
@@ -193,25 +221,42 @@ int WorldSocket::SendPacket(WorldPacket const& pct)
     }
     else
     {
+        if (m_OutQueueSize + pkt->size() + header.getHeaderLength() > WORLDSOCKET_OUT_QUEUE_LIMIT)
+        {
+            sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::SendPacket output queue is full");
+            return -1;
+        }
+
         // Enqueue the packet.
-        ACE_Message_Block* mb;
+        queue_output((const char*) header.header, header.getHeaderLength());
 
-        ACE_NEW_RETURN(mb, ACE_Message_Block(pkt->size() + header.getHeaderLength()), -1);
+        if (!pkt->empty())
+            queue_output((const char*) pkt->contents(), pkt->size());
+    }
 
-        mb->copy((char*) header.header, header.getHeaderLength());
+    return 0;
+}
 
-        if (!pkt->empty())
-            mb->copy((const char*)pkt->contents(), pkt->size());
+void WorldSocket::queue_output (const char* data, size_t len)
+{
+    m_OutQueueSize += len;
 
-        if (msg_queue()->enqueue_tail(mb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-        {
-            sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::SendPacket enqueue_tail failed");
-            mb->release();
-            return -1;
-        }
+    // the queue is a plain byte stream, so a packet may continue in the next block
+    if (!m_OutQueue.empty())
+    {
+        ACE_Message_Block* tail = m_OutQueue.back();
+        size_t part = std::min(tail->space(), len);
+        tail->copy(data, part);
+        data += part;
+        len -= part;
     }
 
-    return 0;
+    if (len == 0)
+        return;
+
+    ACE_Message_Block* mb = sPacketPool->AcquireBlock(len);
+    mb->copy(data, len);
+    m_OutQueue.push_back(mb);
 }
 
 long WorldSocket::AddReference (void)
@@ -330,15 +375,36 @@ int WorldSocket::handle_output (ACE_HANDLE)
     if (closing_)
         return -1;
 
-    size_t send_len = m_OutBuffer->length();
+    // send the buffer and as much of the queue as possible with one vectored write
+    iovec iov[WORLDSOCKET_MAX_IOV];
+    int iovcnt = 0;
+    size_t send_len = 0;
+
+    if (m_OutBuffer->length() > 0)
+    {
+        iov[iovcnt].iov_base = m_OutBuffer->rd_ptr();
+        iov[iovcnt].iov_len = m_OutBuffer->length();
+        send_len += iov[iovcnt++].iov_len;
+    }
+
+    for (OutQueue::const_iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end() && iovcnt < WORLDSOCKET_MAX_IOV; ++itr)
+    {
+        iov[iovcnt].iov_base = (*itr)->rd_ptr();
+        iov[iovcnt].iov_len = (*itr)->length();
+        send_len += iov[iovcnt++].iov_len;
+    }
 
     if (send_len == 0)
-        return handle_output_queue(Guard);
+        return cancel_wakeup_output(Guard);
 
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send (m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    ssize_t n = ACE_OS::sendmsg (get_handle(), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send (m_OutBuffer->rd_ptr(), send_len);
+    ssize_t n = peer().sendv (iov, iovcnt);
 #endif // MSG_NOSIGNAL
 
     if (n == 0)
@@ -350,84 +416,45 @@ int WorldSocket::handle_output (ACE_HANDLE)
 
         return -1;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr (static_cast<size_t> (n));
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
+    size_t sent = static_cast<size_t> (n);
 
-        return schedule_wakeup_output (Guard);
-    }
-    else //now n == send_len
+    if (m_OutBuffer->length() > 0)
     {
-        m_OutBuffer->reset();
-
-        return handle_output_queue (Guard);
-    }
-
-    ACE_NOTREACHED (return 0);
-}
+        size_t part = std::min(sent, m_OutBuffer->length());
+        m_OutBuffer->rd_ptr (part);
+        sent -= part;
 
-int WorldSocket::handle_output_queue (GuardType& g)
-{
-    if (msg_queue()->is_empty())
-        return cancel_wakeup_output(g);
-
-    ACE_Message_Block* mblk;
-
-    if (msg_queue()->dequeue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-    {
-        sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::handle_output_queue dequeue_head");
-        return -1;
+        if (m_OutBuffer->length() == 0)
+            m_OutBuffer->reset();
+        else
+            // move the data to the base of the buffer
+            m_OutBuffer->crunch();
     }
 
-    const size_t send_len = mblk->length();
-
-#ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send (mblk->rd_ptr(), send_len, MSG_NOSIGNAL);
-#else
-    ssize_t n = peer().send (mblk->rd_ptr(), send_len);
-#endif // MSG_NOSIGNAL
-
-    if (n == 0)
+    while (sent > 0)
     {
-        mblk->release();
+        ACE_Message_Block* mblk = m_OutQueue.front();
+        size_t part = std::min(sent, mblk->length());
+        mblk->rd_ptr (part);
+        m_OutQueueSize -= part;
+        sent -= part;
 
-        return -1;
-    }
-    else if (n == -1)
-    {
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
+        if (mblk->length() == 0)
         {
-            msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero);
-            return schedule_wakeup_output (g);
+            sPacketPool->ReleaseBlock(mblk);
+            m_OutQueue.pop_front();
         }
-
-        mblk->release();
-        return -1;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        mblk->rd_ptr(static_cast<size_t> (n));
 
-        if (msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero) == -1)
-        {
-            sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::handle_output_queue enqueue_head");
-            mblk->release();
-            return -1;
-        }
-
-        return schedule_wakeup_output (g);
-    }
-    else //now n == send_len
-    {
-        mblk->release();
+    if (size_t(n) < send_len)
+        return schedule_wakeup_output (Guard);
 
-        return msg_queue()->is_empty() ? cancel_wakeup_output(g) : ACE_Event_Handler::WRITE_MASK;
-    }
+    // everything passed was sent, call again while the queue had more blocks than one write takes
+    if (m_OutBuffer->length() > 0 || !m_OutQueue.empty())
+        return ACE_Event_Handler::WRITE_MASK;
 
-    ACE_NOTREACHED(return -1);
+    return cancel_wakeup_output (Guard);
 }
 
 int WorldSocket::handle_close (ACE_HANDLE h, ACE_Reactor_Mask)
@@ -455,18 +482,25 @@ int WorldSocket::handle_close (ACE_HANDLE h, ACE_Reactor_Mask)
 
 int WorldSocket::Update (void)
 {
-    if (closing_)
+    if (closing_ || m_forceCloseTime < time(NULL))
+    {
+        // the pending authentication, if any, can not complete anymore
+        FinishAuthSession(false);
         return -1;
+    }
 
-    if (m_forceCloseTime < time(NULL))
+    if (m_AuthSession && UpdateAuthSession() == -1)
+    {
+        FinishAuthSession(false);
         return -1;
+    }
 
     if (m_OutActive)
         return 0;
 
     {
         ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, 0);
-        if (m_OutBuffer->length() == 0 && msg_queue()->is_empty())
+        if (m_OutBuffer->length() == 0 && m_OutQueue.empty())
             return 0;
     }
 
@@ -506,11 +540,10 @@ int WorldSocket::handle_input_header (void)
 
     header.size -= 4;
 
-    ACE_NEW_RETURN(m_RecvWPct, WorldPacket (PacketFilter::DropHighBytes(Opcodes(header.cmd)), header.size), -1);
+    m_RecvWPct = sPacketPool->AcquirePacket(PacketFilter::DropHighBytes(Opcodes(header.cmd)), header.size);
 
     if (header.size > 0)
     {
-        m_RecvWPct->resize(header.size);
         m_RecvPct.base ((char*) m_RecvWPct->contents(), m_RecvWPct->size());
     }
     else
@@ -677,7 +710,7 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
     ACE_ASSERT (new_pct);
 
     // manage memory ;)
-    ACE_Auto_Ptr<WorldPacket> aptr(new_pct);
+    PacketPoolGuard aptr(new_pct);
 
     Opcodes opcode = PacketFilter::DropHighBytes(new_pct->GetOpcode());
 
@@ -705,23 +738,29 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
                     return -1;
                 }
 
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                if (m_AuthSession)
+                {
+                    sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::ProcessIncoming: received duplicate CMSG_AUTH_SESSION from %s while authenticating", GetRemoteAddress().c_str());
+                    return -1;
+                }
+
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 return HandleAuthSession(*new_pct);
             case CMSG_KEEP_ALIVE:
                 sLog->outDebug(LOG_FILTER_NETWORKIO, "%s", opcodeName.c_str());
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 return 0;
             case CMSG_LOG_DISCONNECT:
                 new_pct->rfinish(); // contains uint32 disconnectReason;
                 sLog->outDebug(LOG_FILTER_NETWORKIO, "%s", opcodeName.c_str());
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 return 0;
             // not an opcode, client sends string "WORLD OF WARCRAFT CONNECTION - CLIENT TO SERVER" without opcode
             // first 4 bytes become the opcode (2 dropped)
             case MSG_VERIFY_CONNECTIVITY:
             {
                 sLog->outDebug(LOG_FILTER_NETWORKIO, "%s", opcodeName.c_str());
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 std::string str;
                 *new_pct >> str;
                 if (str != "D OF WARCRAFT CONNECTION - CLIENT TO SERVER")
@@ -731,7 +770,7 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
             case CMSG_ENABLE_NAGLE:
             {
                 sLog->outDebug(LOG_FILTER_NETWORKIO, "%s", opcodeName.c_str());
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 return m_Session ? m_Session->HandleEnableNagleAlgorithm() : -1;
             }
             default:
@@ -796,19 +835,58 @@ int WorldSocket::HandleSendAuthSession()
     return SendPacket(packet);
 }
 
+enum AuthSessionStage
+{
+    AUTH_STAGE_QUEUED,                                      // waiting for a slot in WorldSocketMgr
+    AUTH_STAGE_ACCOUNT,                                     // account query running
+    AUTH_STAGE_ACCESS,                                      // security, ban and account data queries running
+    AUTH_STAGE_ADD                                          // authenticated, waiting for SessionAddDelay
+};
+
+/// CMSG_AUTH_SESSION content and the account data collected for it by the asynchronous queries.
+struct WorldSocket::AuthSession
+{
+    AuthSession() : Stage(AUTH_STAGE_QUEUED), HasSlot(false), Queued(false), ClientSeed(0), Id(0), Security(0),
+        Expansion(0), MuteTime(0), Locale(LOCALE_enUS), Recruiter(0), IsRecruiter(false)
+    {
+        memset(Digest, 0, sizeof(Digest));
+    }
+
+    AuthSessionStage Stage;
+    bool HasSlot;
+    bool Queued;
+
+    uint8 Digest[20];
+    uint32 ClientSeed;
+    std::string Account;
+    WorldPacket AddonsData;
+
+    uint32 Id;
+    uint8 Security;
+    uint8 Expansion;
+    int64 MuteTime;
+    LocaleConstant Locale;
+    uint32 Recruiter;
+    bool IsRecruiter;
+    std::string Os;
+    BigNumber K;
+    ACE_Time_Value AddTime;
+
+    PreparedQueryResultFuture AccountResult;
+    PreparedQueryResultFuture SecurityResult;
+    PreparedQueryResultFuture BanResult;
+    PreparedQueryResultFuture RecruiterResult;
+    PreparedQueryResultFuture AccountDataResult;
+    PreparedQueryResultFuture TutorialsResult;
+};
+
 int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 {
-    uint8 digest[20];
-    uint32 clientSeed;
-    uint8 security;
-    uint16 clientBuild;
-    uint32 id;
+    // freed by FinishAuthSession, also when the packet turns out to be malformed
+    m_AuthSession = new AuthSession();
+
+    uint8* digest = m_AuthSession->Digest;
     uint32 addonSize;
-    LocaleConstant locale;
-    std::string account;
-    SHA1Hash sha;
-    BigNumber k;
-    WorldPacket addonsData;
 
     recvPacket.read_skip<uint32>();
     recvPacket.read_skip<uint32>();
@@ -825,7 +903,7 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     recvPacket >> digest[7];
     recvPacket >> digest[16];
     recvPacket >> digest[3];
-    recvPacket >> clientBuild;
+    recvPacket.read_skip<uint16>();                         // client build
     recvPacket >> digest[8];
     recvPacket.read_skip<uint32>();
     recvPacket.read_skip<uint8>();
@@ -834,19 +912,19 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     recvPacket >> digest[0];
     recvPacket >> digest[1];
     recvPacket >> digest[11];
-    recvPacket >> clientSeed;
+    recvPacket >> m_AuthSession->ClientSeed;
     recvPacket >> digest[2];
     recvPacket.read_skip<uint32>();
     recvPacket >> digest[14];
     recvPacket >> digest[13];
 
     recvPacket >> addonSize;
-    addonsData.resize(addonSize);
-    recvPacket.read((uint8*)addonsData.contents(), addonSize);
+    m_AuthSession->AddonsData.resize(addonSize);
+    recvPacket.read((uint8*)m_AuthSession->AddonsData.contents(), addonSize);
 
     recvPacket.ReadBit();
     uint32 accountNameLength = recvPacket.ReadBits(12);
-    account = recvPacket.ReadString(accountNameLength);
+    m_AuthSession->Account = recvPacket.ReadString(accountNameLength);
 
     if (sWorld->IsClosed())
     {
@@ -855,12 +933,70 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         return -1;
     }
 
-    // Get the account information from the realmd database
-    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_ACCOUNT_INFO_BY_NAME);
+    return UpdateAuthSession();
+}
+
+int WorldSocket::UpdateAuthSession()
+{
+    AuthSession* auth = m_AuthSession;
+
+    switch (auth->Stage)
+    {
+        case AUTH_STAGE_QUEUED:
+        {
+            // too many clients are authenticating already, try again on the next update
+            if (!sWorldSocketMgr->AcquireAuthSlot())
+            {
+                if (!auth->Queued)
+                {
+                    auth->Queued = true;
+                    sWorldSocketMgr->SetAuthQueued(true);
+                }
+                return 0;
+            }
 
-    stmt->setString(0, account);
+            if (auth->Queued)
+            {
+                auth->Queued = false;
+                sWorldSocketMgr->SetAuthQueued(false);
+            }
 
-    PreparedQueryResult result = LoginDatabase.Query(stmt);
+            auth->HasSlot = true;
+            auth->Stage = AUTH_STAGE_ACCOUNT;
+
+            // Get the account information from the realmd database
+            PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_ACCOUNT_INFO_BY_NAME);
+            stmt->setString(0, auth->Account);
+            auth->AccountResult = LoginDatabase.AsyncQuery(stmt);
+            return 0;
+        }
+        case AUTH_STAGE_ACCOUNT:
+            if (!auth->AccountResult.ready())
+                return 0;
+
+            return HandleAuthAccountResult();
+        case AUTH_STAGE_ACCESS:
+            if (!auth->SecurityResult.ready() || !auth->BanResult.ready() || !auth->RecruiterResult.ready() ||
+                !auth->AccountDataResult.ready() || !auth->TutorialsResult.ready())
+                return 0;
+
+            return HandleAuthAccessResult();
+        case AUTH_STAGE_ADD:
+            if (ACE_OS::gettimeofday() < auth->AddTime)
+                return 0;
+
+            return AddAuthSession();
+    }
+
+    return 0;
+}
+
+int WorldSocket::HandleAuthAccountResult()
+{
+    AuthSession* auth = m_AuthSession;
+
+    PreparedQueryResult result;
+    auth->AccountResult.get(result);
 
     // Stop if the account is not found
     if (!result)
@@ -872,10 +1008,10 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     Field* fields = result->Fetch();
 
-    uint8 expansion = fields[6].GetUInt8();
+    auth->Expansion = fields[6].GetUInt8();
     uint32 world_expansion = sWorld->getIntConfig(CONFIG_EXPANSION);
-    if (expansion > world_expansion)
-        expansion = world_expansion;
+    if (auth->Expansion > world_expansion)
+        auth->Expansion = world_expansion;
 
     sLog->outDebug(LOG_FILTER_NETWORKIO, "WorldSocket::HandleAuthSession: (s, v) check s: %s v: %s",
         fields[5].GetCString(),
@@ -892,30 +1028,30 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         }
     }
 
-    id = fields[0].GetUInt32();
+    auth->Id = fields[0].GetUInt32();
 
-    k.SetHexStr(fields[1].GetCString());
+    auth->K.SetHexStr(fields[1].GetCString());
 
-    int64 mutetime = fields[7].GetInt64();
+    auth->MuteTime = fields[7].GetInt64();
     //! Negative mutetime indicates amount of seconds to be muted effective on next login - which is now.
-    if (mutetime < 0)
+    if (auth->MuteTime < 0)
     {
-        mutetime = time(NULL) + llabs(mutetime);
+        auth->MuteTime = time(NULL) + llabs(auth->MuteTime);
 
         PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_UPD_MUTE_TIME);
 
-        stmt->setInt64(0, mutetime);
-        stmt->setUInt32(1, id);
+        stmt->setInt64(0, auth->MuteTime);
+        stmt->setUInt32(1, auth->Id);
 
         LoginDatabase.Execute(stmt);
     }
 
-    locale = LocaleConstant (fields[8].GetUInt8());
-    if (locale >= TOTAL_LOCALES)
-        locale = LOCALE_enUS;
+    auth->Locale = LocaleConstant (fields[8].GetUInt8());
+    if (auth->Locale >= TOTAL_LOCALES)
+        auth->Locale = LOCALE_enUS;
 
-    uint32 recruiter = fields[9].GetUInt32();
-    std::string os = fields[10].GetString();
+    auth->Recruiter = fields[9].GetUInt32();
+    auth->Os = fields[10].GetString();
 
     // Must be done before WorldSession is created
     /*
@@ -926,31 +1062,70 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
         return -1;
     }*/
 
+    // The remaining queries only depend on the account id, run them all at once
+
     // Checks gmlevel per Realm
-    stmt = LoginDatabase.GetPreparedStatement(LOGIN_GET_GMLEVEL_BY_REALMID);
+    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_GET_GMLEVEL_BY_REALMID);
 
-    stmt->setUInt32(0, id);
+    stmt->setUInt32(0, auth->Id);
     stmt->setInt32(1, int32(realmID));
 
-    result = LoginDatabase.Query(stmt);
-
-    if (!result)
-        security = 0;
-    else
-    {
-        fields = result->Fetch();
-        security = fields[0].GetUInt8();
-    }
+    auth->SecurityResult = LoginDatabase.AsyncQuery(stmt);
 
     // Re-check account ban (same check as in realmd)
     stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BANS);
 
-    stmt->setUInt32(0, id);
+    stmt->setUInt32(0, auth->Id);
     stmt->setString(1, GetRemoteAddress());
 
-    PreparedQueryResult banresult = LoginDatabase.Query(stmt);
+    auth->BanResult = LoginDatabase.AsyncQuery(stmt);
+
+    // Check if this user is by any chance a recruiter
+    stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_ACCOUNT_RECRUITER);
+
+    stmt->setUInt32(0, auth->Id);
+
+    auth->RecruiterResult = LoginDatabase.AsyncQuery(stmt);
+
+    // Account data and tutorials of the WorldSession
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_ACCOUNT_DATA);
+
+    stmt->setUInt32(0, auth->Id);
+
+    auth->AccountDataResult = CharacterDatabase.AsyncQuery(stmt);
+
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_TUTORIALS);
+
+    stmt->setUInt32(0, auth->Id);
+
+    auth->TutorialsResult = CharacterDatabase.AsyncQuery(stmt);
+
+    auth->Stage = AUTH_STAGE_ACCESS;
+    return 0;
+}
+
+int WorldSocket::HandleAuthAccessResult()
+{
+    AuthSession* auth = m_AuthSession;
+
+    // All queries are done, let the next client in
+    auth->HasSlot = false;
+    sWorldSocketMgr->ReleaseAuthSlot();
+
+    PreparedQueryResult result;
+    auth->SecurityResult.get(result);
+
+    if (!result)
+        auth->Security = 0;
+    else
+    {
+        Field* fields = result->Fetch();
+        auth->Security = fields[0].GetUInt8();
+    }
+
+    auth->BanResult.get(result);
 
-    if (banresult) // if account banned
+    if (result) // if account banned
     {
         SendAuthResponseError(AUTH_BANNED);
         sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::HandleAuthSession: Sent Auth Response (Account banned).");
@@ -959,8 +1134,8 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     // Check locked state for server
     AccountTypes allowedAccountType = sWorld->GetPlayerSecurityLimit();
-    sLog->outDebug(LOG_FILTER_NETWORKIO, "Allowed Level: %u Player Level %u", allowedAccountType, AccountTypes(security));
-    if (allowedAccountType > SEC_PLAYER && AccountTypes(security) < allowedAccountType)
+    sLog->outDebug(LOG_FILTER_NETWORKIO, "Allowed Level: %u Player Level %u", allowedAccountType, AccountTypes(auth->Security));
+    if (allowedAccountType > SEC_PLAYER && AccountTypes(auth->Security) < allowedAccountType)
     {
         SendAuthResponseError(AUTH_UNAVAILABLE);
         sLog->outInfo(LOG_FILTER_NETWORKIO, "WorldSocket::HandleAuthSession: User tries to login but his security level is not enough");
@@ -968,71 +1143,96 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     }
 
     // Check that Key and account name are the same on client and server
+    SHA1Hash sha;
     uint32 t = 0;
     uint32 seed = m_Seed;
 
-    sha.UpdateData(account);
+    sha.UpdateData(auth->Account);
     sha.UpdateData((uint8*)&t, 4);
-    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&auth->ClientSeed, 4);
     sha.UpdateData((uint8*)&seed, 4);
-    sha.UpdateBigNumbers(&k, NULL);
+    sha.UpdateBigNumbers(&auth->K, NULL);
     sha.Finalize();
 
     std::string address = GetRemoteAddress();
 
-    if (memcmp(sha.GetDigest(), digest, 20))
+    if (memcmp(sha.GetDigest(), auth->Digest, 20))
     {
         SendAuthResponseError(AUTH_FAILED);
-        sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::HandleAuthSession: Authentication failed for account: %u ('%s') address: %s", id, account.c_str(), address.c_str());
+        sLog->outError(LOG_FILTER_NETWORKIO, "WorldSocket::HandleAuthSession: Authentication failed for account: %u ('%s') address: %s", auth->Id, auth->Account.c_str(), address.c_str());
         return -1;
     }
 
     sLog->outDebug(LOG_FILTER_NETWORKIO, "WorldSocket::HandleAuthSession: Client '%s' authenticated successfully from %s.",
-        account.c_str(),
+        auth->Account.c_str(),
         address.c_str());
 
-    // Check if this user is by any chance a recruiter
-    stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_ACCOUNT_RECRUITER);
-
-    stmt->setUInt32(0, id);
-
-    result = LoginDatabase.Query(stmt);
+    auth->RecruiterResult.get(result);
 
-    bool isRecruiter = false;
     if (result)
-        isRecruiter = true;
+        auth->IsRecruiter = true;
 
     // Update the last_ip in the database
 
-    stmt = LoginDatabase.GetPreparedStatement(LOGIN_UPD_LAST_IP);
+    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_UPD_LAST_IP);
 
     stmt->setString(0, address);
-    stmt->setString(1, account);
+    stmt->setString(1, auth->Account);
 
     LoginDatabase.Execute(stmt);
 
+    // Delay adding the session, without blocking the other sockets of this network thread
+    auth->AddTime = ACE_OS::gettimeofday() + ACE_Time_Value(0, sWorld->getIntConfig(CONFIG_SESSION_ADD_DELAY));
+    auth->Stage = AUTH_STAGE_ADD;
+    return 0;
+}
+
+int WorldSocket::AddAuthSession()
+{
+    AuthSession* auth = m_AuthSession;
+
     // NOTE ATM the socket is single-threaded, have this in mind ...
-    ACE_NEW_RETURN(m_Session, WorldSession(id, this, AccountTypes(security), expansion, mutetime, locale, recruiter, isRecruiter), -1);
+    ACE_NEW_RETURN(m_Session, WorldSession(auth->Id, this, AccountTypes(auth->Security), auth->Expansion, auth->MuteTime, auth->Locale, auth->Recruiter, auth->IsRecruiter), -1);
+
+    m_Crypt.Init(&auth->K);
 
-    m_Crypt.Init(&k);
+    PreparedQueryResult result;
+    auth->AccountDataResult.get(result);
+    m_Session->LoadAccountData(result, GLOBAL_CACHE_MASK);
 
-    m_Session->LoadGlobalAccountData();
-    m_Session->LoadTutorialsData();
-    m_Session->ReadAddonsInfo(addonsData);
+    auth->TutorialsResult.get(result);
+    m_Session->LoadTutorialsData(result);
+
+    m_Session->ReadAddonsInfo(auth->AddonsData);
 
     // Initialize Warden system only if it is enabled by config
     if (sWorld->getBoolConfig(CONFIG_WARDEN_ENABLED))
-        m_Session->InitWarden(&k, os);
-
-    // Sleep this Network thread for
-    uint32 sleepTime = sWorld->getIntConfig(CONFIG_SESSION_ADD_DELAY);
-    ACE_OS::sleep(ACE_Time_Value(0, sleepTime));
+        m_Session->InitWarden(&auth->K, auth->Os);
 
     sWorld->AddSession(m_Session);
     m_forceCloseTime = 0x8FFFFFFF;
+
+    FinishAuthSession(true);
     return 0;
 }
 
+void WorldSocket::FinishAuthSession(bool succeeded)
+{
+    if (!m_AuthSession)
+        return;
+
+    if (m_AuthSession->Queued)
+        sWorldSocketMgr->SetAuthQueued(false);
+
+    if (m_AuthSession->HasSlot)
+        sWorldSocketMgr->ReleaseAuthSlot();
+
+    sWorldSocketMgr->OnAuthFinished(succeeded);
+
+    delete m_AuthSession;
+    m_AuthSession = NULL;
+}
+
 int WorldSocket::HandlePing (WorldPacket& recvPacket)
 {
     uint32 ping;
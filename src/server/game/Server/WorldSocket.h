@@ -34,6 +34,8 @@
 #include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
 
+#include <deque>
+
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
 #endif /* ACE_LACKS_PRAGMA_ONCE */
@@ -42,6 +44,7 @@
 #include "AuthCrypt.h"
 
 class ACE_Message_Block;
+class BroadcastPacket;
 class WorldPacket;
 class WorldSession;
 
@@ -110,6 +113,9 @@ class WorldSocket : public WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Send a packet shared with other sockets, see BroadcastPacket.
+        int SendPacket(const BroadcastPacket& packet);
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -150,16 +156,30 @@ class WorldSocket : public WorldHandler
         int cancel_wakeup_output(GuardType& g);
         int schedule_wakeup_output(GuardType& g);
 
-        /// Drain the queue if its not empty.
-        int handle_output_queue(GuardType& g);
+        /// Append data to the output queue, used once m_OutBuffer is full.
+        void queue_output(const char* data, size_t len);
+
+        /// Common part of the SendPacket overloads, broadcast is NULL for packets of this socket only.
+        int SendPacket(const WorldPacket& pct, const BroadcastPacket* broadcast);
 
         /// process one incoming packet.
         /// @param new_pct received packet, note that you need to delete it.
         int ProcessIncoming(WorldPacket* new_pct);
 
-        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
+        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION, the account is
+        /// checked asynchronously by UpdateAuthSession().
         int HandleAuthSession(WorldPacket& recvPacket);
 
+        /// Called by Update() while an authentication is pending, advances it
+        /// once the results of its database queries are ready.
+        int UpdateAuthSession();
+        int HandleAuthAccountResult();
+        int HandleAuthAccessResult();
+        int AddAuthSession();
+
+        /// Forget the pending authentication and release its slot in WorldSocketMgr.
+        void FinishAuthSession(bool succeeded);
+
         /// Called by ProcessIncoming() on CMSG_PING.
         int HandlePing(WorldPacket& recvPacket);
 
@@ -167,6 +187,8 @@ class WorldSocket : public WorldHandler
         int HandleSendAuthSession();
 
     private:
+        struct AuthSession;
+
         void SendAuthResponseError(uint8);
         /// Time in which the last ping was received
         ACE_Time_Value m_LastPingTime;
@@ -186,6 +208,9 @@ class WorldSocket : public WorldHandler
         /// Session to which received packets are routed
         WorldSession* m_Session;
 
+        /// Authentication waiting for the databases, NULL otherwise
+        AuthSession* m_AuthSession;
+
         /// here are stored the fragments of the received data
         WorldPacket* m_RecvWPct;
 
@@ -206,6 +231,14 @@ class WorldSocket : public WorldHandler
         /// Size of the m_OutBuffer.
         size_t m_OutBufferSize;
 
+        /// Data which did not fit in m_OutBuffer, packets are appended to the last block
+        /// while it has space, so the number of blocks grows with the bytes queued.
+        typedef std::deque<ACE_Message_Block*> OutQueue;
+        OutQueue m_OutQueue;
+
+        /// Bytes waiting in m_OutQueue.
+        size_t m_OutQueueSize;
+
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
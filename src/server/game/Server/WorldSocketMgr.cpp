@@ -217,6 +217,12 @@ WorldSocketMgr::WorldSocketMgr() :
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_UseNoDelay(true),
+    m_MaxPendingAuths(100),
+    m_PendingAuths(0),
+    m_QueuedAuths(0),
+    m_SucceededAuths(0),
+    m_FailedAuths(0),
+    m_PendingAuthsPeak(0),
     m_Acceptor (0)
 {
 }
@@ -257,6 +263,14 @@ WorldSocketMgr::StartReactiveIO (ACE_UINT16 port, const char* address)
         return -1;
     }
 
+    m_MaxPendingAuths = ConfigMgr::GetIntDefault ("Network.MaxPendingAuths", 100);
+
+    if (m_MaxPendingAuths <= 0)
+    {
+        sLog->outError(LOG_FILTER_GENERAL, "Network.MaxPendingAuths is wrong in your config file");
+        return -1;
+    }
+
     m_Acceptor = new WorldSocketAcceptor;
 
     ACE_INET_Addr listen_addr (port, address);
@@ -316,6 +330,51 @@ WorldSocketMgr::Wait()
     }
 }
 
+bool
+WorldSocketMgr::AcquireAuthSlot()
+{
+    long pending = ++m_PendingAuths;
+
+    if (pending > m_MaxPendingAuths)
+    {
+        --m_PendingAuths;
+        return false;
+    }
+
+    if (pending > m_PendingAuthsPeak)
+        m_PendingAuthsPeak = pending;
+
+    return true;
+}
+
+void
+WorldSocketMgr::SetAuthQueued(bool queued)
+{
+    if (queued)
+        ++m_QueuedAuths;
+    else
+        --m_QueuedAuths;
+}
+
+void
+WorldSocketMgr::OnAuthFinished(bool succeeded)
+{
+    if (succeeded)
+        ++m_SucceededAuths;
+    else
+        ++m_FailedAuths;
+}
+
+void
+WorldSocketMgr::GetAuthStats(AuthStats& stats) const
+{
+    stats.Pending = m_PendingAuths.value();
+    stats.Queued = m_QueuedAuths.value();
+    stats.PendingPeak = m_PendingAuthsPeak;
+    stats.Succeeded = m_SucceededAuths.value();
+    stats.Failed = m_FailedAuths.value();
+}
+
 int
 WorldSocketMgr::OnSocketOpen (WorldSocket* sock)
 {
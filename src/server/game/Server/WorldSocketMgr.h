@@ -28,6 +28,7 @@
 #include <ace/Basic_Types.h>
 #include <ace/Singleton.h>
 #include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
 
 class WorldSocket;
 class ReactorRunnable;
@@ -49,9 +50,27 @@ public:
     /// Wait untill all network threads have "joined" .
     void Wait();
 
+    struct AuthStats
+    {
+        long Pending;                                       // waiting for the login database
+        long Queued;                                        // waiting for a pending slot
+        long PendingPeak;
+        long Succeeded;
+        long Failed;
+    };
+
+    void GetAuthStats(AuthStats& stats) const;
+    long GetMaxPendingAuths() const { return m_MaxPendingAuths; }
+
 private:
     int OnSocketOpen(WorldSocket* sock);
 
+    /// Authentications of WorldSocket, at most Network.MaxPendingAuths of them query the databases at once.
+    bool AcquireAuthSlot();
+    void ReleaseAuthSlot() { --m_PendingAuths; }
+    void SetAuthQueued(bool queued);
+    void OnAuthFinished(bool succeeded);
+
     int StartReactiveIO(ACE_UINT16 port, const char* address);
 
 private:
@@ -65,6 +84,15 @@ private:
     int m_SockOutUBuff;
     bool m_UseNoDelay;
 
+    typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> AtomicCounter;
+
+    long m_MaxPendingAuths;
+    AtomicCounter m_PendingAuths;
+    AtomicCounter m_QueuedAuths;
+    AtomicCounter m_SucceededAuths;
+    AtomicCounter m_FailedAuths;
+    long m_PendingAuthsPeak;                                // updated without lock, only informative
+
     class WorldSocketAcceptor* m_Acceptor;
 };
 
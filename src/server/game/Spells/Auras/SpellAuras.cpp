@@ -1019,9 +1019,10 @@ void Aura::UnregisterSingleTarget()
     Unit* caster = GetCaster();
     // TODO: find a better way to do this.
     if (!caster)
-        caster = ObjectAccessor::GetObjectInOrOutOfWorld(GetCasterGUID(), (Unit*)NULL);
-    ASSERT(caster);
-    caster->GetSingleCastAuras().remove(this);
+        caster = ObjectAccessor::GetUnitInOrOutOfWorld(*GetOwner(), GetCasterGUID());
+    // a creature caster not on our map has left the world, which removed its single target auras from its list
+    if (caster)
+        caster->GetSingleCastAuras().remove(this);
     SetIsSingleTarget(false);
 }
 
@@ -2437,7 +2437,7 @@ void Spell::DoAllEffectOnTarget(TargetInfo* target)
         if (!farMask)
             return;
         // find unit in world
-        unit = ObjectAccessor::FindUnit(target->targetGUID);
+        unit = ObjectAccessor::GetUnit(*m_caster, target->targetGUID);
         if (!unit)
             return;
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TickBudget.h"
+#include "Common.h"
+
+TickBudget::TickBudget() : _budget(0), _maxDeferredTicks(0), _tickTimeAccumulator(0), _maxTickTime(0),
+    _ticks(0), _overrunTicks(0), _sheddingTicks(0), _shedding(false)
+{
+    for (uint8 i = 0; i < MAX_TICK_STAGES; ++i)
+        _stageTimeAccumulator[i] = 0;
+
+    for (uint8 i = 0; i < MAX_DEFERRABLE_WORK; ++i)
+    {
+        _deferred[i] = 0;
+        _forced[i] = 0;
+    }
+}
+
+void TickBudget::SetBudget(uint32 budget, uint32 maxDeferredTicks)
+{
+    _budget = budget;
+    _maxDeferredTicks = maxDeferredTicks;
+
+    if (!_budget || !_maxDeferredTicks)
+        _shedding = false;
+}
+
+void TickBudget::RecordStageTime(TickStage stage, uint32 time)
+{
+    _stageTimeAccumulator[stage] += time - _stageTimeAccumulator[stage] / 8;
+}
+
+void TickBudget::OnTickEnd(uint32 tickTime)
+{
+    _tickTimeAccumulator += tickTime - _tickTimeAccumulator / 8;
+    _maxTickTime = std::max(_maxTickTime, tickTime);
+    ++_ticks;
+
+    if (!_budget || !_maxDeferredTicks)
+        return;
+
+    if (tickTime > _budget)
+        ++_overrunTicks;
+
+    // shed load as soon as the average goes over the budget, but only stop
+    // well below it so that the deferred work does not push it right back
+    uint32 averageTickTime = _tickTimeAccumulator / 8;
+    if (averageTickTime > _budget)
+        _shedding = true;
+    else if (averageTickTime <= _budget * 3 / 4)
+        _shedding = false;
+
+    if (_shedding)
+        ++_sheddingTicks;
+}
+
+bool TickBudget::Defer(DeferrableWork work, uint32& deferredTicks)
+{
+    if (!_shedding)
+    {
+        deferredTicks = 0;
+        return false;
+    }
+
+    if (deferredTicks >= _maxDeferredTicks)
+    {
+        ++_forced[work];
+        deferredTicks = 0;
+        return false;
+    }
+
+    ++_deferred[work];
+    ++deferredTicks;
+    return true;
+}
+
+bool TickBudget::DeferSince(DeferrableWork work, uint32& deferredSince)
+{
+    if (!_shedding)
+    {
+        deferredSince = 0;
+        return false;
+    }
+
+    if (!deferredSince)
+        deferredSince = _ticks + 1;
+    else if (_ticks + 1 - deferredSince >= _maxDeferredTicks)
+    {
+        ++_forced[work];
+        deferredSince = 0;
+        return false;
+    }
+
+    ++_deferred[work];
+    return true;
+}
+
+void TickBudget::GetStats(Stats& stats) const
+{
+    stats.Budget = _budget;
+    stats.AverageTickTime = _tickTimeAccumulator / 8;
+    stats.MaxTickTime = _maxTickTime;
+    for (uint8 i = 0; i < MAX_TICK_STAGES; ++i)
+        stats.AverageStageTime[i] = _stageTimeAccumulator[i] / 8;
+    stats.Ticks = _ticks;
+    stats.OverrunTicks = _overrunTicks;
+    stats.SheddingTicks = _sheddingTicks;
+    stats.Shedding = _shedding;
+    for (uint8 i = 0; i < MAX_DEFERRABLE_WORK; ++i)
+    {
+        stats.Deferred[i] = _deferred[i].value();
+        stats.Forced[i] = _forced[i].value();
+    }
+}
+
+char const* TickBudget::GetWorkName(DeferrableWork work)
+{
+    switch (work)
+    {
+        case DEFERRABLE_RELOCATION_NOTIFIES:
+            return "relocation notifies";
+        case DEFERRABLE_ACTIVE_OBJECT_CELLS:
+            return "active object cells";
+        case DEFERRABLE_AUTOSAVES:
+            return "autosaves";
+        case DEFERRABLE_WEATHER:
+            return "weather";
+        case DEFERRABLE_GAME_EVENTS:
+            return "game events";
+        default:
+            return "unknown";
+    }
+}
+
+char const* TickBudget::GetStageName(TickStage stage)
+{
+    switch (stage)
+    {
+        case TICK_STAGE_WORLD:
+            return "world";
+        case TICK_STAGE_SESSIONS:
+            return "sessions";
+        case TICK_STAGE_UPDATE_TASKS:
+            return "update tasks";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_TICKBUDGET_H
+#define TRINITY_TICKBUDGET_H
+
+#include "Define.h"
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+// Work which can wait for a later tick when the world update runs over its budget
+enum DeferrableWork
+{
+    DEFERRABLE_RELOCATION_NOTIFIES  = 0,                    // visibility and AI notifies of moved units, per map
+    DEFERRABLE_ACTIVE_OBJECT_CELLS  = 1,                    // cells visited only for non-player active objects, away from players
+    DEFERRABLE_AUTOSAVES            = 2,
+    DEFERRABLE_WEATHER              = 3,
+    DEFERRABLE_GAME_EVENTS          = 4,
+    MAX_DEFERRABLE_WORK
+};
+
+// Parts of World::Update measured separately
+enum TickStage
+{
+    TICK_STAGE_WORLD                = 0,                    // timers, quest resets, auctions and mails
+    TICK_STAGE_SESSIONS             = 1,
+    TICK_STAGE_UPDATE_TASKS         = 2,                    // maps and the other tasks of WorldUpdateScheduler
+    MAX_TICK_STAGES
+};
+
+// Keeps the world tick within its budget. While the average tick time is over the budget the
+// deferrable work is postponed to later ticks, so combat and movement do not slow down with it.
+// No work is postponed more than a configured number of ticks in a row.
+class TickBudget
+{
+    public:
+        struct Stats
+        {
+            uint32 Budget;
+            uint32 AverageTickTime;
+            uint32 MaxTickTime;
+            uint32 AverageStageTime[MAX_TICK_STAGES];
+            uint32 Ticks;
+            uint32 OverrunTicks;
+            uint32 SheddingTicks;
+            bool Shedding;
+            long Deferred[MAX_DEFERRABLE_WORK];
+            long Forced[MAX_DEFERRABLE_WORK];               // ran while shedding because it was postponed too long
+        };
+
+        TickBudget();
+
+        // a budget of 0 disables the load shedding
+        void SetBudget(uint32 budget, uint32 maxDeferredTicks);
+
+        void RecordStageTime(TickStage stage, uint32 time);
+
+        // called by the world thread when all updates of the tick are done
+        void OnTickEnd(uint32 tickTime);
+
+        bool IsShedding() const { return _shedding; }
+
+        // returns true if due work should be skipped in this tick. deferredTicks counts the skips
+        // in a row and belongs to the caller, so map threads can use it for their own objects.
+        bool Defer(DeferrableWork work, uint32& deferredTicks);
+
+        // same for work retried less often than every tick. deferredSince holds the tick it was first
+        // skipped in (plus one, 0 while not postponed), so the limit still counts ticks, not retries.
+        bool DeferSince(DeferrableWork work, uint32& deferredSince);
+
+        void GetStats(Stats& stats) const;
+
+        static char const* GetWorkName(DeferrableWork work);
+        static char const* GetStageName(TickStage stage);
+
+    private:
+        uint32 _budget;
+        uint32 _maxDeferredTicks;
+
+        uint32 _tickTimeAccumulator;                        // 8 times the moving average
+        uint32 _stageTimeAccumulator[MAX_TICK_STAGES];
+        uint32 _maxTickTime;
+        uint32 _ticks;
+        uint32 _overrunTicks;
+        uint32 _sheddingTicks;
+        bool _shedding;                                     // only changed between the ticks
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> _deferred[MAX_DEFERRABLE_WORK];
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> _forced[MAX_DEFERRABLE_WORK];
+};
+
+#endif
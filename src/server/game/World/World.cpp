@@ -120,6 +120,9 @@ World::World()
     m_updateTimeSum = 0;
     m_updateTimeCount = 0;
 
+    m_deferredWeatherTicks = 0;
+    m_deferredGameEventTicks = 0;
+
     m_isClosed = false;
 
     m_CleaningFlags = 0;
@@ -1251,6 +1254,10 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_INTERVAL_LOG_UPDATE] = ConfigMgr::GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_int_configs[CONFIG_MIN_LOG_UPDATE] = ConfigMgr::GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_int_configs[CONFIG_NUMTHREADS] = ConfigMgr::GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_WORLD_UPDATE_THREADS] = ConfigMgr::GetIntDefault("WorldUpdate.Threads", 1);
+    m_int_configs[CONFIG_WORLD_TICK_BUDGET] = ConfigMgr::GetIntDefault("WorldUpdate.TickBudget", 0);
+    m_int_configs[CONFIG_WORLD_MAX_DEFERRED_TICKS] = ConfigMgr::GetIntDefault("WorldUpdate.MaxDeferredTicks", 20);
+    m_tickBudget.SetBudget(m_int_configs[CONFIG_WORLD_TICK_BUDGET], m_int_configs[CONFIG_WORLD_MAX_DEFERRED_TICKS]);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = ConfigMgr::GetIntDefault("Command.LookupMaxResults", 0);
 
     // chat logging
@@ -1298,6 +1305,7 @@ void World::LoadConfigSettings(bool reload)
     // Guild save interval
     m_bool_configs[CONFIG_GUILD_LEVELING_ENABLED] = ConfigMgr::GetBoolDefault("Guild.LevelingEnabled", true);
     m_int_configs[CONFIG_GUILD_SAVE_INTERVAL] = ConfigMgr::GetIntDefault("Guild.SaveInterval", 15);
+    m_int_configs[CONFIG_GUILD_SAVE_BUDGET] = ConfigMgr::GetIntDefault("Guild.SaveBudget", 100);
     m_int_configs[CONFIG_GUILD_MAX_LEVEL] = ConfigMgr::GetIntDefault("Guild.MaxLevel", 25);
     m_int_configs[CONFIG_GUILD_UNDELETABLE_LEVEL] = ConfigMgr::GetIntDefault("Guild.UndeletableLevel", 4);
     rate_values[RATE_XP_QUEST_GUILD_MODIFIER] = ConfigMgr::GetFloatDefault("Guild.XPQuestModifier", 0.25f);
@@ -1873,6 +1881,9 @@ void World::SetInitialWorldSettings()
     sLog->outInfo(LOG_FILTER_SERVER_LOADING, "Starting Map System");
     sMapMgr->Initialize();
 
+    sLog->outInfo(LOG_FILTER_SERVER_LOADING, "Starting World update tasks...");
+    _InitUpdateTasks();
+
     sLog->outInfo(LOG_FILTER_SERVER_LOADING, "Starting Game Event system...");
     uint32 nextGameEvent = sGameEventMgr->StartSystem();
     m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);    //depend on next event
@@ -2057,6 +2068,7 @@ void World::LoadAutobroadcasts()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    uint32 tickStartTime = getMSTime();
     m_updateTime = diff;
 
     if (m_int_configs[CONFIG_INTERVAL_LOG_UPDATE] && diff > m_int_configs[CONFIG_MIN_LOG_UPDATE])
@@ -2126,14 +2138,25 @@ void World::Update(uint32 diff)
         ///- Handle expired auctions
         sAuctionMgr->Update();
     }
+    ///- Continue a mass expiry of auctions, a bounded number per update
+    else if (sAuctionMgr->HasExpiryBacklog())
+        sAuctionMgr->Update();
+
+    ///- Continue returning or deleting old mails, a bounded number per update
+    sObjectMgr->UpdateOldMails();
+
+    uint32 stageStartTime = getMSTime();
+    m_tickBudget.RecordStageTime(TICK_STAGE_WORLD, getMSTimeDiff(tickStartTime, stageStartTime));
 
     /// <li> Handle session updates when the timer has passed
     RecordTimeDiff(NULL);
     UpdateSessions(diff);
     RecordTimeDiff("UpdateSessions");
 
-    /// <li> Handle weather updates when the timer has passed
-    if (m_timers[WUPDATE_WEATHERS].Passed())
+    m_tickBudget.RecordStageTime(TICK_STAGE_SESSIONS, GetMSTimeDiffToNow(stageStartTime));
+
+    /// <li> Handle weather updates when the timer has passed, the timer stays passed while they are deferred
+    if (m_timers[WUPDATE_WEATHERS].Passed() && !m_tickBudget.Defer(DEFERRABLE_WEATHER, m_deferredWeatherTicks))
     {
         m_timers[WUPDATE_WEATHERS].Reset();
         WeatherMgr::Update(uint32(m_timers[WUPDATE_WEATHERS].GetInterval()));
@@ -2148,7 +2171,84 @@ void World::Update(uint32 diff)
         }
     }
 
-    /// <li> Update uptime table
+    /// <li> Handle all other objects, the independent ones concurrently (maps, battlegrounds, database pings, ...)
+    RecordTimeDiff(NULL);
+    stageStartTime = getMSTime();
+    m_updateScheduler.Run(this, diff);
+    m_tickBudget.RecordStageTime(TICK_STAGE_UPDATE_TASKS, GetMSTimeDiffToNow(stageStartTime));
+    for (size_t i = 0; i < m_updateScheduler.GetTaskCount(); ++i)
+        _RecordTaskTime(m_updateScheduler.GetTaskName(i), m_updateScheduler.GetTaskTime(i));
+    RecordTimeDiff("UpdateTasks");
+
+    // And last, but not least handle the issued cli commands
+    ProcessCliCommands();
+
+    sScriptMgr->OnWorldUpdate(diff);
+
+    sPerfLog->Update(diff);
+
+    // decides whether the next tick sheds load, all map and task threads are idle by now
+    m_tickBudget.OnTickEnd(GetMSTimeDiffToNow(tickStartTime));
+}
+
+void World::_InitUpdateTasks()
+{
+    // Added in the order of the former serial update, which conflicting tasks keep. Most managers
+    // act on players and objects of the maps, so only the tasks not touching them overlap with the maps.
+    m_updateScheduler.AddTask("UpdateMapMgr", &World::_UpdateMapsTask,
+        WORLD_RESOURCE_SESSIONS | WORLD_RESOURCE_CHARACTER_CACHE,
+        WORLD_RESOURCE_MAPS | WORLD_RESOURCE_BATTLEGROUNDS | WORLD_RESOURCE_OUTDOOR_PVP | WORLD_RESOURCE_BATTLEFIELDS |
+        WORLD_RESOURCE_LFG | WORLD_RESOURCE_GROUPS | WORLD_RESOURCE_GUILDS | WORLD_RESOURCE_INSTANCE_SAVES);
+    m_updateScheduler.AddTask("UpdateUptime", &World::_UpdateUptimeTask, WORLD_RESOURCE_NONE, WORLD_RESOURCE_NONE);
+    m_updateScheduler.AddTask("CleanLogs", &World::_CleanLogsTask, WORLD_RESOURCE_NONE, WORLD_RESOURCE_NONE);
+    m_updateScheduler.AddTask("AutoBroadcast", &World::_AutoBroadcastTask,
+        WORLD_RESOURCE_SESSIONS | WORLD_RESOURCE_MAPS, WORLD_RESOURCE_NONE);
+    m_updateScheduler.AddTask("UpdateBattlegroundMgr", &World::_UpdateBattlegroundsTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_BATTLEGROUNDS | WORLD_RESOURCE_MAPS | WORLD_RESOURCE_GROUPS);
+    m_updateScheduler.AddTask("UpdateOutdoorPvPMgr", &World::_UpdateOutdoorPvPTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_OUTDOOR_PVP | WORLD_RESOURCE_MAPS);
+    m_updateScheduler.AddTask("BattlefieldMgr", &World::_UpdateBattlefieldsTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_BATTLEFIELDS | WORLD_RESOURCE_MAPS | WORLD_RESOURCE_GROUPS);
+    m_updateScheduler.AddTask("DeleteOldCharacters", &World::_DeleteOldCharactersTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_CHARACTER_CACHE | WORLD_RESOURCE_GUILDS | WORLD_RESOURCE_GROUPS | WORLD_RESOURCE_MAPS |
+        WORLD_RESOURCE_QUERY_CALLBACKS);
+    m_updateScheduler.AddTask("UpdateLFGMgr", &World::_UpdateLFGTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_LFG | WORLD_RESOURCE_GROUPS | WORLD_RESOURCE_MAPS);
+    m_updateScheduler.AddTask("ProcessQueryCallbacks", &World::_ProcessQueryCallbacksTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_QUERY_CALLBACKS);
+    m_updateScheduler.AddTask("RemoveOldCorpses", &World::_RemoveOldCorpsesTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_MAPS);
+    m_updateScheduler.AddTask("UpdateGameEvents", &World::_UpdateGameEventsTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_GAME_EVENTS | WORLD_RESOURCE_MAPS | WORLD_RESOURCE_BATTLEGROUNDS);
+    m_updateScheduler.AddTask("PingDatabases", &World::_PingDatabasesTask, WORLD_RESOURCE_NONE, WORLD_RESOURCE_NONE);
+    m_updateScheduler.AddTask("SaveGuilds", &World::_SaveGuildsTask,
+        WORLD_RESOURCE_MAPS, WORLD_RESOURCE_GUILDS);
+    m_updateScheduler.AddTask("UpdateInstanceSaves", &World::_UpdateInstanceSavesTask,
+        WORLD_RESOURCE_NONE, WORLD_RESOURCE_INSTANCE_SAVES | WORLD_RESOURCE_MAPS | WORLD_RESOURCE_GROUPS);
+
+    uint32 threads = getIntConfig(CONFIG_WORLD_UPDATE_THREADS);
+    if (threads && m_updateScheduler.activate(threads) == -1)
+        sLog->outError(LOG_FILTER_GENERAL, "World: could not start %u world update threads, the world update tasks run in the world thread", threads);
+}
+
+void World::_RecordTaskTime(char const* name, uint32 diff)
+{
+    if (m_updateTimeCount != 1)
+        return;
+
+    if (diff > m_int_configs[CONFIG_MIN_LOG_UPDATE])
+        sLog->outInfo(LOG_FILTER_GENERAL, "Difftime %s: %u.", name, diff);
+}
+
+///- Update objects when the timer has passed (maps, transport, creatures, ...)
+void World::_UpdateMapsTask(uint32 diff)
+{
+    sMapMgr->Update(diff);
+}
+
+/// Update uptime table
+void World::_UpdateUptimeTask(uint32 /*diff*/)
+{
     if (m_timers[WUPDATE_UPTIME].Passed())
     {
         uint32 tmpDiff = uint32(m_gameTime - m_startTime);
@@ -2165,8 +2265,11 @@ void World::Update(uint32 diff)
 
         LoginDatabase.Execute(stmt);
     }
+}
 
-    /// <li> Clean logs table
+/// Clean logs table
+void World::_CleanLogsTask(uint32 /*diff*/)
+{
     if (sWorld->getIntConfig(CONFIG_LOGDB_CLEARTIME) > 0) // if not enabled, ignore the timer
     {
         if (m_timers[WUPDATE_CLEANDB].Passed())
@@ -2181,13 +2284,10 @@ void World::Update(uint32 diff)
             LoginDatabase.Execute(stmt);
         }
     }
+}
 
-    /// <li> Handle all other objects
-    ///- Update objects when the timer has passed (maps, transport, creatures, ...)
-    RecordTimeDiff(NULL);
-    sMapMgr->Update(diff);
-    RecordTimeDiff("UpdateMapMgr");
-
+void World::_AutoBroadcastTask(uint32 /*diff*/)
+{
     if (sWorld->getBoolConfig(CONFIG_AUTOBROADCAST))
     {
         if (m_timers[WUPDATE_AUTOBROADCAST].Passed())
@@ -2196,47 +2296,69 @@ void World::Update(uint32 diff)
             SendAutoBroadcast();
         }
     }
+}
 
+void World::_UpdateBattlegroundsTask(uint32 diff)
+{
     sBattlegroundMgr->Update(diff);
-    RecordTimeDiff("UpdateBattlegroundMgr");
+}
 
+void World::_UpdateOutdoorPvPTask(uint32 diff)
+{
     sOutdoorPvPMgr->Update(diff);
-    RecordTimeDiff("UpdateOutdoorPvPMgr");
+}
 
+void World::_UpdateBattlefieldsTask(uint32 diff)
+{
     sBattlefieldMgr->Update(diff);
-    RecordTimeDiff("BattlefieldMgr");
+}
 
-    ///- Delete all characters which have been deleted X days before
+///- Delete all characters which have been deleted X days before
+void World::_DeleteOldCharactersTask(uint32 /*diff*/)
+{
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
         m_timers[WUPDATE_DELETECHARS].Reset();
         Player::DeleteOldCharacters();
     }
+}
 
+void World::_UpdateLFGTask(uint32 diff)
+{
     sLFGMgr->Update(diff);
-    RecordTimeDiff("UpdateLFGMgr");
+}
 
-    // execute callbacks from sql queries that were queued recently
+// execute callbacks from sql queries that were queued recently
+void World::_ProcessQueryCallbacksTask(uint32 /*diff*/)
+{
     ProcessQueryCallbacks();
-    RecordTimeDiff("ProcessQueryCallbacks");
+}
 
-    ///- Erase corpses once every 20 minutes
+///- Erase corpses once every 20 minutes
+void World::_RemoveOldCorpsesTask(uint32 /*diff*/)
+{
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
         m_timers[WUPDATE_CORPSES].Reset();
         sObjectAccessor->RemoveOldCorpses();
     }
+}
 
-    ///- Process Game events when necessary
-    if (m_timers[WUPDATE_EVENTS].Passed())
+///- Process Game events when necessary
+void World::_UpdateGameEventsTask(uint32 /*diff*/)
+{
+    if (m_timers[WUPDATE_EVENTS].Passed() && !m_tickBudget.Defer(DEFERRABLE_GAME_EVENTS, m_deferredGameEventTicks))
     {
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
         uint32 nextGameEvent = sGameEventMgr->Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
         m_timers[WUPDATE_EVENTS].Reset();
     }
+}
 
-    ///- Ping to keep MySQL connections alive
+///- Ping to keep MySQL connections alive
+void World::_PingDatabasesTask(uint32 /*diff*/)
+{
     if (m_timers[WUPDATE_PINGDB].Passed())
     {
         m_timers[WUPDATE_PINGDB].Reset();
@@ -2245,22 +2367,23 @@ void World::Update(uint32 diff)
         LoginDatabase.KeepAlive();
         WorldDatabase.KeepAlive();
     }
+}
 
+void World::_SaveGuildsTask(uint32 /*diff*/)
+{
     if (m_timers[WUPDATE_GUILDSAVE].Passed())
     {
         m_timers[WUPDATE_GUILDSAVE].Reset();
         sGuildMgr->SaveGuilds();
     }
 
-    // update the instance reset times
-    sInstanceSaveMgr->Update();
-
-    // And last, but not least handle the issued cli commands
-    ProcessCliCommands();
-
-    sScriptMgr->OnWorldUpdate(diff);
+    sGuildMgr->UpdateSaveSweep(getIntConfig(CONFIG_GUILD_SAVE_BUDGET));
+}
 
-    sPerfLog->Update(diff);
+// update the instance reset times
+void World::_UpdateInstanceSavesTask(uint32 /*diff*/)
+{
+    sInstanceSaveMgr->Update();
 }
 
 void World::ForceGameEventUpdate()
@@ -2274,6 +2397,7 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    BroadcastPacket broadcast(*packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2283,7 +2407,7 @@ void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 te
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(broadcast);
         }
     }
 }
@@ -2291,6 +2415,7 @@ void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 te
 /// Send a packet to all GMs (except self if mentioned)
 void World::SendGlobalGMMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    BroadcastPacket broadcast(*packet);
     SessionMap::iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2301,7 +2426,7 @@ void World::SendGlobalGMMessage(WorldPacket* packet, WorldSession* self, uint32
             !AccountMgr::IsPlayerAccount(itr->second->GetSecurity()) &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(broadcast);
         }
     }
 }
@@ -2425,6 +2550,7 @@ void World::SendGlobalText(const char* text, WorldSession* self)
 /// Send a packet to all players (or players selected team) in the zone (except self if mentioned)
 void World::SendZoneMessage(uint32 zone, WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    BroadcastPacket broadcast(*packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -2435,7 +2561,7 @@ void World::SendZoneMessage(uint32 zone, WorldPacket* packet, WorldSession* self
             itr->second != self &&
             (team == 0 || itr->second->GetPlayer()->GetTeam() == team))
         {
-            itr->second->SendPacket(packet);
+            itr->second->SendPacket(broadcast);
         }
     }
 }
@@ -30,6 +30,8 @@
 #include "SharedDefines.h"
 #include "QueryResult.h"
 #include "Callback.h"
+#include "WorldUpdateScheduler.h"
+#include "TickBudget.h"
 
 #include <map>
 #include <set>
@@ -329,6 +331,9 @@ enum WorldIntConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_WORLD_UPDATE_THREADS,
+    CONFIG_WORLD_TICK_BUDGET,
+    CONFIG_WORLD_MAX_DEFERRED_TICKS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -371,6 +376,7 @@ enum WorldIntConfigs
     CONFIG_TOL_BARAD_BATTLETIME,
     CONFIG_TOL_BARAD_NOBATTLETIME,
     CONFIG_GUILD_SAVE_INTERVAL,
+    CONFIG_GUILD_SAVE_BUDGET,
     CONFIG_GUILD_MAX_LEVEL,
     CONFIG_GUILD_UNDELETABLE_LEVEL,
     CONFIG_GUILD_DAILY_XP_CAP,
@@ -784,6 +790,10 @@ class World
 
         void RecordTimeDiff(const char * text, ...);
 
+        void StopUpdateThreads() { m_updateScheduler.deactivate(); }
+
+        TickBudget& GetTickBudget() { return m_tickBudget; }
+
         void LoadAutobroadcasts();
 
         void UpdateAreaDependentAuras();
@@ -819,6 +829,28 @@ class World
         void ResetRandomBG();
         void ResetGuildCap();
         void ResetCurrencyWeekCap();
+
+        // tasks of the world update following the session updates, see _InitUpdateTasks
+        void _InitUpdateTasks();
+        void _RecordTaskTime(char const* name, uint32 diff);
+        void _UpdateMapsTask(uint32 diff);
+        void _UpdateUptimeTask(uint32 diff);
+        void _CleanLogsTask(uint32 diff);
+        void _AutoBroadcastTask(uint32 diff);
+        void _UpdateBattlegroundsTask(uint32 diff);
+        void _UpdateOutdoorPvPTask(uint32 diff);
+        void _UpdateBattlefieldsTask(uint32 diff);
+        void _DeleteOldCharactersTask(uint32 diff);
+        void _UpdateLFGTask(uint32 diff);
+        void _ProcessQueryCallbacksTask(uint32 diff);
+        void _RemoveOldCorpsesTask(uint32 diff);
+        void _UpdateGameEventsTask(uint32 diff);
+        void _PingDatabasesTask(uint32 diff);
+        void _SaveGuildsTask(uint32 diff);
+        void _UpdateInstanceSavesTask(uint32 diff);
+
+        WorldUpdateScheduler m_updateScheduler;
+        TickBudget m_tickBudget;
     private:
         static ACE_Atomic_Op<ACE_Thread_Mutex, bool> m_stopEvent;
         static uint8 m_ExitCode;
@@ -832,6 +864,8 @@ class World
         time_t m_startTime;
         time_t m_gameTime;
         IntervalTimer m_timers[WUPDATE_COUNT];
+        uint32 m_deferredWeatherTicks;
+        uint32 m_deferredGameEventTicks;
         time_t mail_timer;
         time_t mail_timer_expires;
         uint32 m_updateTime, m_updateTimeSum;
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldUpdateScheduler.h"
+#include "Common.h"
+#include "Timer.h"
+
+WorldUpdateScheduler::WorldUpdateScheduler() :
+m_remaining(0), m_world(NULL), m_diff(0), m_mutex(), m_condition(m_mutex), m_activated(false), m_stopping(false)
+{
+}
+
+WorldUpdateScheduler::~WorldUpdateScheduler()
+{
+    deactivate();
+}
+
+void WorldUpdateScheduler::AddTask(char const* name, TaskHandler handler, uint32 reads, uint32 writes)
+{
+    Task task;
+    task.name = name;
+    task.handler = handler;
+    task.reads = reads;
+    task.writes = writes;
+    task.started = false;
+    task.finished = false;
+    task.time = 0;
+
+    // conflicting tasks keep the order they were added in, as in a serial update
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+        if ((writes & (m_tasks[i].reads | m_tasks[i].writes)) || (reads & m_tasks[i].writes))
+            task.dependencies.push_back(i);
+
+    m_tasks.push_back(task);
+}
+
+int WorldUpdateScheduler::activate(size_t num_threads)
+{
+    if (activated() || num_threads < 1)
+        return -1;
+
+    m_stopping = false;
+
+    if (ACE_Task_Base::activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, int(num_threads)) == -1)
+        return -1;
+
+    m_activated = true;
+    return 0;
+}
+
+int WorldUpdateScheduler::deactivate()
+{
+    if (!activated())
+        return -1;
+
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+        m_stopping = true;
+        m_condition.broadcast();
+    }
+
+    ACE_Task_Base::wait();
+    m_activated = false;
+    return 0;
+}
+
+void WorldUpdateScheduler::Run(World* world, uint32 diff)
+{
+    {
+        TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+
+        m_world = world;
+        m_diff = diff;
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+            m_tasks[i].started = m_tasks[i].finished = false;
+        m_remaining = m_tasks.size();
+
+        m_condition.broadcast();
+    }
+
+    for (;;)
+    {
+        size_t index;
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+
+            while (m_remaining && !_takeReadyTask(index))
+                m_condition.wait();
+
+            if (!m_remaining)
+                break;
+        }
+
+        _runTask(index);
+    }
+}
+
+int WorldUpdateScheduler::svc()
+{
+    for (;;)
+    {
+        size_t index;
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+
+            while (!m_stopping && !_takeReadyTask(index))
+                m_condition.wait();
+
+            if (m_stopping)
+                break;
+        }
+
+        _runTask(index);
+    }
+
+    return 0;
+}
+
+// called with m_mutex held, takes the first task whose dependencies are done
+bool WorldUpdateScheduler::_takeReadyTask(size_t& index)
+{
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        Task& task = m_tasks[i];
+        if (task.started)
+            continue;
+
+        bool ready = true;
+        for (size_t j = 0; j < task.dependencies.size() && ready; ++j)
+            ready = m_tasks[task.dependencies[j]].finished;
+
+        if (!ready)
+            continue;
+
+        task.started = true;
+        index = i;
+        return true;
+    }
+
+    return false;
+}
+
+void WorldUpdateScheduler::_runTask(size_t index)
+{
+    Task& task = m_tasks[index];
+
+    uint32 startTime = getMSTime();
+    (m_world->*task.handler)(m_diff);
+    task.time = GetMSTimeDiffToNow(startTime);
+
+    TRINITY_GUARD(ACE_Thread_Mutex, m_mutex);
+    task.finished = true;
+    --m_remaining;
+    m_condition.broadcast();
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2008-2013 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_WORLDUPDATESCHEDULER_H
+#define TRINITY_WORLDUPDATESCHEDULER_H
+
+#include "Define.h"
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include <vector>
+
+class World;
+
+// Data touched by the tasks of the world update. A task runs concurrently with the tasks added
+// before it unless one of them writes data which the other one reads or writes.
+enum WorldUpdateResource
+{
+    WORLD_RESOURCE_NONE             = 0x0000,
+    WORLD_RESOURCE_MAPS             = 0x0001,               // map contents: players, creatures, gameobjects, transports
+    WORLD_RESOURCE_BATTLEGROUNDS    = 0x0002,
+    WORLD_RESOURCE_OUTDOOR_PVP      = 0x0004,
+    WORLD_RESOURCE_BATTLEFIELDS     = 0x0008,
+    WORLD_RESOURCE_LFG              = 0x0010,
+    WORLD_RESOURCE_GROUPS           = 0x0020,
+    WORLD_RESOURCE_GUILDS           = 0x0040,
+    WORLD_RESOURCE_INSTANCE_SAVES   = 0x0080,
+    WORLD_RESOURCE_GAME_EVENTS      = 0x0100,
+    WORLD_RESOURCE_CHARACTER_CACHE  = 0x0200,               // character name data kept by World
+    WORLD_RESOURCE_SESSIONS         = 0x0400,               // session list kept by World
+    WORLD_RESOURCE_QUERY_CALLBACKS  = 0x0800
+};
+
+// Runs the parts of World::Update after the session updates as a task graph
+class WorldUpdateScheduler : protected ACE_Task_Base
+{
+    public:
+        typedef void (World::*TaskHandler)(uint32 diff);
+
+        WorldUpdateScheduler();
+        virtual ~WorldUpdateScheduler();
+
+        void AddTask(char const* name, TaskHandler handler, uint32 reads, uint32 writes);
+
+        int activate(size_t num_threads);
+        int deactivate();
+        bool activated() const { return m_activated; }
+
+        // runs every task once, the calling thread takes part and returns when all are done
+        void Run(World* world, uint32 diff);
+
+        size_t GetTaskCount() const { return m_tasks.size(); }
+        char const* GetTaskName(size_t index) const { return m_tasks[index].name; }
+        uint32 GetTaskTime(size_t index) const { return m_tasks[index].time; }
+
+        virtual int svc();
+
+    private:
+        struct Task
+        {
+            char const* name;
+            TaskHandler handler;
+            uint32 reads;
+            uint32 writes;
+            std::vector<size_t> dependencies;               // tasks added before this one which it conflicts with
+            bool started;
+            bool finished;
+            uint32 time;                                    // duration of the last run
+        };
+
+        bool _takeReadyTask(size_t& index);
+        void _runTask(size_t index);
+
+        std::vector<Task> m_tasks;
+        size_t m_remaining;
+
+        World* m_world;
+        uint32 m_diff;
+
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        bool m_activated;
+        bool m_stopping;
+};
+
+#endif
@@ -24,11 +24,16 @@ EndScriptData */
 
 #include "Chat.h"
 #include "Config.h"
+#include "DatabaseEnv.h"
+#include "GuildMgr.h"
 #include "Language.h"
+#include "MapManager.h"
 #include "ObjectAccessor.h"
+#include "PacketPool.h"
 #include "Player.h"
 #include "ScriptMgr.h"
 #include "SystemConfig.h"
+#include "WorldSocketMgr.h"
 
 class server_commandscript : public CommandScript
 {
@@ -76,16 +81,21 @@ public:
 
         static ChatCommand serverCommandTable[] =
         {
+            { "auths",          SEC_ADMINISTRATOR,  true,  &HandleServerAuthsCommand,               "", NULL },
             { "corpses",        SEC_GAMEMASTER,     true,  &HandleServerCorpsesCommand,             "", NULL },
+            { "database",       SEC_ADMINISTRATOR,  true,  &HandleServerDatabaseCommand,            "", NULL },
             { "exit",           SEC_CONSOLE,        true,  &HandleServerExitCommand,                "", NULL },
             { "idlerestart",    SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverIdleRestartCommandTable },
             { "idleshutdown",   SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverIdleShutdownCommandTable },
             { "info",           SEC_PLAYER,         true,  &HandleServerInfoCommand,                "", NULL },
+            { "maps",           SEC_ADMINISTRATOR,  true,  &HandleServerMapsCommand,                "", NULL },
             { "motd",           SEC_PLAYER,         true,  &HandleServerMotdCommand,                "", NULL },
+            { "packetpool",     SEC_ADMINISTRATOR,  true,  &HandleServerPacketPoolCommand,          "", NULL },
             { "plimit",         SEC_ADMINISTRATOR,  true,  &HandleServerPLimitCommand,              "", NULL },
             { "restart",        SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverRestartCommandTable },
             { "shutdown",       SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverShutdownCommandTable },
             { "set",            SEC_ADMINISTRATOR,  true,  NULL,                                    "", serverSetCommandTable },
+            { "tick",           SEC_ADMINISTRATOR,  true,  &HandleServerTickCommand,                "", NULL },
             { NULL,             0,                  false, NULL,                                    "", NULL }
         };
 
@@ -97,6 +107,61 @@ public:
         return commandTable;
     }
 
+    // Display the client authentications handled by the network threads
+    static bool HandleServerAuthsCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        WorldSocketMgr::AuthStats stats;
+        sWorldSocketMgr->GetAuthStats(stats);
+
+        handler->PSendSysMessage("Authentications: %li pending (limit %li, at most %li), %li queued, %li succeeded, %li failed",
+            stats.Pending, sWorldSocketMgr->GetMaxPendingAuths(), stats.PendingPeak, stats.Queued, stats.Succeeded, stats.Failed);
+
+        return true;
+    }
+
+    // Display the waits for the synchronous database connections and the statements holding them the longest,
+    // and the queue of the asynchronous ones
+    static bool HandleServerDatabaseCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        ShowDatabasePoolStats(handler, "World", WorldDatabase);
+        ShowDatabasePoolStats(handler, "Character", CharacterDatabase);
+        ShowDatabasePoolStats(handler, "Login", LoginDatabase);
+
+        GuildMgr::SaveSweepStats const& guildSave = sGuildMgr->GetLastSaveSweepStats();
+        handler->PSendSysMessage("Last guild save: %u rows for %u of %u guilds in %u ticks%s",
+            guildSave.Rows, guildSave.ChangedGuilds, guildSave.Guilds, guildSave.Ticks, sGuildMgr->IsSaveSweepRunning() ? ", next one running" : "");
+        return true;
+    }
+
+    template<class T>
+    static void ShowDatabasePoolStats(ChatHandler* handler, char const* name, DatabaseWorkerPool<T>& database)
+    {
+        typename DatabaseWorkerPool<T>::PoolStats stats;
+        database.GetPoolStats(stats);
+
+        handler->PSendSysMessage("%s database: %u connections, " UI64FMTD " acquired, " UI64FMTD " had to wait, " UI64FMTD " timed out, %u waiting",
+            name, stats.Connections, stats.Acquired, stats.Contended, stats.TimedOut, stats.Waiting);
+
+        if (stats.Acquired)
+            handler->PSendSysMessage("  wait avg %.2f ms max %.2f ms, hold avg %.2f ms max %.2f ms",
+                stats.TotalWaitTime / 1000.0 / stats.Acquired, stats.MaxWaitTime / 1000.0,
+                stats.TotalHoldTime / 1000.0 / stats.Acquired, stats.MaxHoldTime / 1000.0);
+
+        typename DatabaseWorkerPool<T>::AsyncStats asyncStats;
+        database.GetAsyncStats(asyncStats);
+
+        handler->PSendSysMessage("  async: %u queued, " UI64FMTD " executed, " UI64FMTD " in " UI64FMTD " batches, " UI64FMTD " batches replayed, queue time avg %.2f ms max %u ms",
+            asyncStats.Queued, asyncStats.Operations, asyncStats.BatchedOperations, asyncStats.Batches, asyncStats.Replayed,
+            asyncStats.Operations ? double(asyncStats.TotalQueueTime) / asyncStats.Operations : 0.0, asyncStats.MaxQueueTime);
+
+        std::vector<typename DatabaseWorkerPool<T>::HolderStats> holders;
+        database.GetTopHolders(holders, 5);
+
+        for (size_t i = 0; i < holders.size(); ++i)
+            handler->PSendSysMessage("  %.1f ms in " UI64FMTD " calls, max %.2f ms: %s", holders[i].TotalHoldTime / 1000.0,
+                holders[i].Count, holders[i].MaxHoldTime / 1000.0, holders[i].Query.empty() ? "<ad-hoc>" : holders[i].Query.c_str());
+    }
+
     // Triggering corpses expire check in world
     static bool HandleServerCorpsesCommand(ChatHandler* /*handler*/, char const* /*args*/)
     {
@@ -126,6 +191,62 @@ public:
 
         return true;
     }
+    // Display the slowest map updates (average, last and max time per map instance)
+    static bool HandleServerMapsCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 count = 10;
+        if (*args)
+            count = uint32(atoi((char*)args));
+
+        std::vector<Map const*> maps;
+        sMapMgr->GetMapsByUpdateTime(maps);
+
+        for (std::vector<Map const*>::const_iterator itr = maps.begin(); itr != maps.end() && count; ++itr, --count)
+        {
+            Map const* map = *itr;
+            handler->PSendSysMessage("Map %u (%s) instance %u: avg %u ms, last %u ms, max %u ms, %u players",
+                map->GetId(), map->GetMapName(), map->GetInstanceId(), map->GetAverageUpdateTime(),
+                map->GetLastUpdateTime(), map->GetMaxUpdateTime(), map->GetPlayers().getSize());
+        }
+
+        return true;
+    }
+
+    static bool HandleServerPacketPoolCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        PacketPool::Stats stats;
+
+        sPacketPool->GetPacketStats(stats);
+        handler->PSendSysMessage("Packets: %li acquired, %li reused, %li in use, %li at most",
+            stats.Acquired, stats.Reused, stats.InUse, stats.HighWaterMark);
+
+        sPacketPool->GetBlockStats(stats);
+        handler->PSendSysMessage("Output blocks: %li acquired, %li reused, %li in use, %li at most",
+            stats.Acquired, stats.Reused, stats.InUse, stats.HighWaterMark);
+
+        return true;
+    }
+
+    // Display the world tick times and the work postponed to keep them within the tick budget
+    static bool HandleServerTickCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        TickBudget::Stats stats;
+        sWorld->GetTickBudget().GetStats(stats);
+
+        handler->PSendSysMessage("World tick: avg %u ms, max %u ms, budget %u ms%s", stats.AverageTickTime, stats.MaxTickTime,
+            stats.Budget, stats.Budget ? (stats.Shedding ? ", shedding load" : "") : " (load shedding disabled)");
+
+        for (uint8 i = 0; i < MAX_TICK_STAGES; ++i)
+            handler->PSendSysMessage("  %s: avg %u ms", TickBudget::GetStageName(TickStage(i)), stats.AverageStageTime[i]);
+
+        handler->PSendSysMessage("%u ticks, %u over the budget, %u shedding load", stats.Ticks, stats.OverrunTicks, stats.SheddingTicks);
+
+        for (uint8 i = 0; i < MAX_DEFERRABLE_WORK; ++i)
+            handler->PSendSysMessage("  %s: %li deferred, %li forced", TickBudget::GetWorkName(DeferrableWork(i)), stats.Deferred[i], stats.Forced[i]);
+
+        return true;
+    }
+
     // Display the 'Message of the day' for the realm
     static bool HandleServerMotdCommand(ChatHandler* handler, char const* /*args*/)
     {
@@ -157,7 +157,7 @@ void OPvPCapturePointGH::ChangeState()
         break;
     }
 
-    GameObject* flag = HashMapHolder<GameObject>::Find(m_capturePointGUID);
+    GameObject* flag = ObjectAccessor::FindSpawnedGameObject(m_capturePointGUID);
     if (flag)
     {
         flag->SetGoArtKit(artkit);
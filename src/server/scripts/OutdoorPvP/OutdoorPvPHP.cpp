@@ -250,8 +250,8 @@ void OPvPCapturePointHP::ChangeState()
         break;
     }
 
-    GameObject* flag = HashMapHolder<GameObject>::Find(m_capturePointGUID);
-    GameObject* flag2 = HashMapHolder<GameObject>::Find(m_Objects[m_TowerType]);
+    GameObject* flag = ObjectAccessor::FindSpawnedGameObject(m_capturePointGUID);
+    GameObject* flag2 = ObjectAccessor::FindSpawnedGameObject(m_Objects[m_TowerType]);
     if (flag)
     {
         flag->SetGoArtKit(artkit);
@@ -63,7 +63,7 @@ uint32 OPvPCapturePointNA::GetAliveGuardsCount()
         case NA_NPC_GUARD_13:
         case NA_NPC_GUARD_14:
         case NA_NPC_GUARD_15:
-            if (Creature const* const cr = HashMapHolder<Creature>::Find(itr->second))
+            if (Creature const* const cr = ObjectAccessor::FindSpawnedCreature(itr->second))
                 if (cr->isAlive())
                     ++cnt;
             break;
@@ -600,7 +600,7 @@ void OPvPCapturePointNA::ChangeState()
         break;
     }
 
-    GameObject* flag = HashMapHolder<GameObject>::Find(m_capturePointGUID);
+    GameObject* flag = ObjectAccessor::FindSpawnedGameObject(m_capturePointGUID);
     if (flag)
     {
         flag->SetGoArtKit(artkit);
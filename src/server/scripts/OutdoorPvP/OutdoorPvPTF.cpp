@@ -322,7 +322,7 @@ void OPvPCapturePointTF::ChangeState()
         break;
     }
 
-    GameObject* flag = HashMapHolder<GameObject>::Find(m_capturePointGUID);
+    GameObject* flag = ObjectAccessor::FindSpawnedGameObject(m_capturePointGUID);
     if (flag)
         flag->SetGoArtKit(artkit);
 
@@ -350,7 +350,7 @@ bool OPvPCapturePointZM_GraveYard::HandleGossipOption(Player* player, uint64 gui
     std::map<uint64, uint32>::iterator itr = m_CreatureTypes.find(guid);
     if (itr != m_CreatureTypes.end())
     {
-        Creature* cr = HashMapHolder<Creature>::Find(guid);
+        Creature* cr = ObjectAccessor::GetCreature(*player, guid);
         if (!cr)
             return true;
         // if the flag is already taken, then return
@@ -1976,7 +1976,7 @@ public:
 
             if (Unit* owner = me->GetOwner())
             {
-                if (victim = ObjectAccessor::FindUnit(targetGuid))
+                if (victim = ObjectAccessor::GetUnit(*me, targetGuid))
                 {
                     if (!init)
                     {
@@ -37,6 +37,11 @@ BasicStatementTask::~BasicStatementTask()
     free((void*)m_sql);
 }
 
+bool BasicStatementTask::IsBatchable(MySQLConnection* /*conn*/) const
+{
+    return !m_has_result && !MySQLConnection::CommitsImplicitly(m_sql);
+}
+
 bool BasicStatementTask::Execute()
 {
     if (m_has_result)
@@ -20,10 +20,15 @@
 #include "SQLOperation.h"
 #include "MySQLConnection.h"
 #include "MySQLThreading.h"
+#include "Timer.h"
+
+#include <mysqld_error.h>
 
 DatabaseWorker::DatabaseWorker(ACE_Activation_Queue* new_queue, MySQLConnection* con) :
 m_queue(new_queue),
-m_conn(con)
+m_conn(con),
+m_maxBatchSize(1),
+m_stats(NULL)
 {
     /// Assign thread to task
     activate();
@@ -35,17 +40,129 @@ int DatabaseWorker::svc()
         return -1;
 
     SQLOperation *request = NULL;
+    std::vector<SQLOperation*> batch;
     while (1)
     {
         request = (SQLOperation*)(m_queue->dequeue());
         if (!request)
             break;
 
-        request->SetConnection(m_conn);
-        request->call();
+        // Take the one-way operations already queued behind this one, without waiting for more.
+        // The batch only grows while the queue is backed up, a lone write still runs on its own.
+        if (m_maxBatchSize > 1 && request->IsBatchable(m_conn))
+        {
+            batch.push_back(request);
+            request = NULL;
+
+            while (batch.size() < m_maxBatchSize)
+            {
+                ACE_Time_Value noWait = ACE_OS::gettimeofday();
+                SQLOperation* next = (SQLOperation*)(m_queue->dequeue(&noWait));
+                if (!next)
+                    break;
+
+                if (!next->IsBatchable(m_conn))
+                {
+                    request = next;
+                    break;
+                }
 
-        delete request;
+                batch.push_back(next);
+            }
+
+            _ExecuteBatch(batch);
+            batch.clear();
+        }
+
+        if (request)
+            _Execute(request);
     }
 
     return 0;
 }
+
+void DatabaseWorker::_Execute(SQLOperation* request)
+{
+    _UpdateQueueTime(request);
+
+    request->SetConnection(m_conn);
+    request->call();
+
+    delete request;
+}
+
+//! Runs the operations in one transaction, so the server commits them at once instead of one by one.
+//! If the transaction is lost (deadlock or reconnect) all operations run again on their own, in order.
+//! None of them commits implicitly, so nothing of a lost transaction has been applied yet.
+void DatabaseWorker::_ExecuteBatch(std::vector<SQLOperation*>& batch)
+{
+    if (batch.size() == 1)
+    {
+        _Execute(batch[0]);
+        return;
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        _UpdateQueueTime(batch[i]);
+        batch[i]->SetConnection(m_conn);
+    }
+
+    if (m_stats)
+    {
+        ++m_stats->Batches;
+        m_stats->BatchedOperations += long(batch.size());
+    }
+
+    uint64 threadId = m_conn->GetThreadId();
+
+    // an operation interrupted by a reconnect must not run again on the new connection by itself,
+    // it would be applied before the ones in front of it when the batch is replayed
+    m_conn->SetRetryOnReconnect(false);
+
+    // without the transaction the operations would be committed one by one and applied again
+    // by the replay, so the batch counts as lost before anything runs on a new connection
+    bool begun = m_conn->Execute("START TRANSACTION") && m_conn->GetThreadId() == threadId;
+
+    size_t i = 0;
+    for (; begun && i < batch.size(); ++i)
+    {
+        bool success = batch[i]->ExecuteInBatch();
+
+        if (m_conn->GetThreadId() != threadId)
+            break;
+
+        if (!success && m_conn->GetLastError() == ER_LOCK_DEADLOCK)
+        {
+            m_conn->RollbackTransaction();
+            break;
+        }
+    }
+
+    bool committed = begun && i == batch.size() && m_conn->Execute("COMMIT") && m_conn->GetThreadId() == threadId;
+    m_conn->SetRetryOnReconnect(true);
+
+    if (!committed && m_stats)
+        ++m_stats->Replayed;
+
+    for (i = 0; i < batch.size(); ++i)
+    {
+        if (!committed)
+            batch[i]->call();
+
+        delete batch[i];
+    }
+}
+
+void DatabaseWorker::_UpdateQueueTime(SQLOperation const* request)
+{
+    if (!m_stats)
+        return;
+
+    uint32 queueTime = GetMSTimeDiffToNow(request->m_queueTime);
+
+    ++m_stats->Operations;
+    m_stats->TotalQueueTime += long(queueTime);
+    if (queueTime > m_stats->MaxQueueTime)
+        m_stats->MaxQueueTime = queueTime;
+}
@@ -20,8 +20,26 @@
 
 #include <ace/Task.h>
 #include <ace/Activation_Queue.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include "Define.h"
 
 class MySQLConnection;
+class SQLOperation;
+
+//! Counters shared by the workers of a DatabaseWorkerPool, queue times in milliseconds
+struct DatabaseWorkerStats
+{
+    DatabaseWorkerStats() : Operations(0), Batches(0), BatchedOperations(0), Replayed(0), TotalQueueTime(0), MaxQueueTime(0) { }
+
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> Operations;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> Batches;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> BatchedOperations;
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> Replayed;          //! Batches run again one by one after a deadlock or reconnect
+    ACE_Atomic_Op<ACE_Thread_Mutex, long> TotalQueueTime;
+    uint32 MaxQueueTime;                                    //! Updated without lock, only informative
+};
 
 class DatabaseWorker : protected ACE_Task_Base
 {
@@ -32,10 +50,21 @@ class DatabaseWorker : protected ACE_Task_Base
         int svc();
         int wait() { return ACE_Task_Base::wait(); }
 
+        //! Both have to be set before anything is queued
+        void SetMaxBatchSize(uint32 size) { m_maxBatchSize = size; }
+        void SetStats(DatabaseWorkerStats* stats) { m_stats = stats; }
+
     private:
         DatabaseWorker() : ACE_Task_Base() {}
+
+        void _Execute(SQLOperation* request);
+        void _ExecuteBatch(std::vector<SQLOperation*>& batch);
+        void _UpdateQueueTime(SQLOperation const* request);
+
         ACE_Activation_Queue* m_queue;
         MySQLConnection* m_conn;
+        uint32 m_maxBatchSize;                              //! 1 runs every operation on its own
+        DatabaseWorkerStats* m_stats;
 };
 
 #endif
@@ -19,6 +19,8 @@
 #define _DATABASEWORKERPOOL_H
 
 #include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/OS_NS_sys_time.h>
 
 #include "Common.h"
 #include "Callback.h"
@@ -30,6 +32,7 @@
 #include "QueryResult.h"
 #include "QueryHolder.h"
 #include "AdhocStatement.h"
+#include "Timer.h"
 
 #define MIN_MYSQL_SERVER_VERSION 50100u
 #define MIN_MYSQL_CLIENT_VERSION 50100u
@@ -48,9 +51,46 @@ template <class T>
 class DatabaseWorkerPool
 {
     public:
+        //! Usage of the synchronous connections, times in microseconds
+        struct PoolStats
+        {
+            uint64 Acquired;        //! Connections handed out
+            uint64 Contended;       //! Of them the caller had to wait for
+            uint64 TimedOut;        //! Callers that gave up waiting
+            uint64 TotalWaitTime;
+            uint32 MaxWaitTime;
+            uint64 TotalHoldTime;
+            uint32 MaxHoldTime;
+            uint32 Waiting;         //! Callers waiting right now
+            uint32 Connections;
+        };
+
+        //! Work of the asynchronous connections, times in milliseconds
+        struct AsyncStats
+        {
+            uint32 Queued;          //! Operations waiting for a worker right now
+            uint64 Operations;
+            uint64 Batches;         //! Operations committed together, see DatabaseWorker::_ExecuteBatch
+            uint64 BatchedOperations;
+            uint64 Replayed;
+            uint64 TotalQueueTime;
+            uint32 MaxQueueTime;
+        };
+
+        //! Time a statement held its synchronous connection
+        struct HolderStats
+        {
+            HolderStats() : Count(0), TotalHoldTime(0), MaxHoldTime(0) { }
+
+            std::string Query;      //! Prepared SQL, or the slowest one for ad-hoc queries
+            uint64 Count;
+            uint64 TotalHoldTime;
+            uint32 MaxHoldTime;
+        };
+
         /* Activity state */
         DatabaseWorkerPool() :
-        _queue(new ACE_Activation_Queue())
+        _queue(new ACE_Activation_Queue()), _poolLock(), _stats()
         {
             memset(_connectionCount, 0, sizeof(_connectionCount));
             _connections.resize(IDX_SIZE);
@@ -80,6 +120,7 @@ class DatabaseWorkerPool
                 if (res) // only check mysql version if connection is valid
                     WPFatal(mysql_get_server_version(t->GetHandle()) >= MIN_MYSQL_SERVER_VERSION, "TrinityCore does not support MySQL versions below 5.1");
                 _connections[IDX_ASYNC][i] = t;
+                t->m_worker->SetStats(&_asyncStats);
                 ++_connectionCount[IDX_ASYNC];
             }
 
@@ -90,6 +131,7 @@ class DatabaseWorkerPool
                 T* t = new T(_connectionInfo);
                 res &= t->Open();
                 _connections[IDX_SYNCH][i] = t;
+                _freeConnections.push_back(t);
                 ++_connectionCount[IDX_SYNCH];
             }
 
@@ -186,9 +228,10 @@ class DatabaseWorkerPool
             if (!sql)
                 return;
 
-            T* t = GetFreeConnection();
+            uint64 acquireTime;
+            T* t = GetFreeConnection(acquireTime);
             t->Execute(sql);
-            t->Unlock();
+            ReleaseConnection(t, acquireTime, SITE_ADHOC, sql);
         }
 
         //! Directly executes a one-way SQL operation in string format -with variable args-, that will block the calling thread until finished.
@@ -211,9 +254,11 @@ class DatabaseWorkerPool
         //! Statement must be prepared with the CONNECTION_SYNCH flag.
         void DirectExecute(PreparedStatement* stmt)
         {
-            T* t = GetFreeConnection();
+            uint32 index = stmt->GetIndex();
+            uint64 acquireTime;
+            T* t = GetFreeConnection(acquireTime);
             t->Execute(stmt);
-            t->Unlock();
+            ReleaseConnection(t, acquireTime, index);
         }
 
         /**
@@ -222,13 +267,20 @@ class DatabaseWorkerPool
 
         //! Directly executes an SQL query in string format that will block the calling thread until finished.
         //! Returns reference counted auto pointer, no need for manual memory management in upper level code.
+        //! A connection passed by the caller is not returned to the pool.
         QueryResult Query(const char* sql, MySQLConnection* conn = NULL)
         {
-            if (!conn)
-                conn = GetFreeConnection();
+            ResultSet* result;
+            if (conn)
+                result = conn->Query(sql);
+            else
+            {
+                uint64 acquireTime;
+                T* t = GetFreeConnection(acquireTime);
+                result = t->Query(sql);
+                ReleaseConnection(t, acquireTime, SITE_ADHOC, sql);
+            }
 
-            ResultSet* result = conn->Query(sql);
-            conn->Unlock();
             if (!result || !result->GetRowCount())
             {
                 delete result;
@@ -274,11 +326,22 @@ class DatabaseWorkerPool
         //! Directly executes an SQL query in prepared format that will block the calling thread until finished.
         //! Returns reference counted auto pointer, no need for manual memory management in upper level code.
         //! Statement must be prepared with CONNECTION_SYNCH flag.
-        PreparedQueryResult Query(PreparedStatement* stmt)
+        //! With a timeout (in milliseconds) an empty result is returned when no connection got free in time.
+        PreparedQueryResult Query(PreparedStatement* stmt, uint32 timeout = 0)
         {
-            T* t = GetFreeConnection();
+            uint32 index = stmt->GetIndex();
+            uint64 acquireTime;
+            T* t = GetFreeConnection(acquireTime, timeout);
+            if (!t)
+            {
+                sLog->outError(LOG_FILTER_SQL_DRIVER, "DatabasePool '%s': no synchronous connection got free in %u ms for statement %u, query dropped.",
+                    GetDatabaseName(), timeout, index);
+                delete stmt;
+                return PreparedQueryResult(NULL);
+            }
+
             PreparedResultSet* ret = t->Query(stmt);
-            t->Unlock();
+            ReleaseConnection(t, acquireTime, index);
 
             //! Delete proxy-class. Not needed anymore
             delete stmt;
@@ -380,10 +443,11 @@ class DatabaseWorkerPool
         //! were appended to the transaction will be respected during execution.
         void DirectCommitTransaction(SQLTransaction& transaction)
         {
-            MySQLConnection* con = GetFreeConnection();
+            uint64 acquireTime;
+            T* con = GetFreeConnection(acquireTime);
             if (con->ExecuteTransaction(transaction))
             {
-                con->Unlock();      // OK, operation succesful
+                ReleaseConnection(con, acquireTime, SITE_TRANSACTION);      // OK, operation succesful
                 return;
             }
 
@@ -402,7 +466,7 @@ class DatabaseWorkerPool
             //! Clean up now.
             transaction->Cleanup();
 
-            con->Unlock();
+            ReleaseConnection(con, acquireTime, SITE_TRANSACTION);
         }
 
         //! Method used to execute prepared statements in a diverse context.
@@ -452,15 +516,20 @@ class DatabaseWorkerPool
         //! Keeps all our MySQL connections alive, prevent the server from disconnecting us.
         void KeepAlive()
         {
-            //! Ping synchronous connections
-            for (uint8 i = 0; i < _connectionCount[IDX_SYNCH]; ++i)
+            //! Ping the idle synchronous connections, the busy ones are obviously alive
+            std::deque<T*> idle;
             {
-                T* t = _connections[IDX_SYNCH][i];
-                if (t->LockIfReady())
-                {
-                    t->Ping();
-                    t->Unlock();
-                }
+                TRINITY_GUARD(ACE_Thread_Mutex, _poolLock);
+                idle.swap(_freeConnections);
+            }
+
+            for (typename std::deque<T*>::iterator itr = idle.begin(); itr != idle.end(); ++itr)
+                (*itr)->Ping();
+
+            {
+                TRINITY_GUARD(ACE_Thread_Mutex, _poolLock);
+                for (typename std::deque<T*>::iterator itr = idle.begin(); itr != idle.end(); ++itr)
+                    _ReturnConnection(*itr);
             }
 
             //! Assuming all worker threads are free, every worker thread will receive 1 ping operation request
@@ -470,7 +539,93 @@ class DatabaseWorkerPool
                 Enqueue(new PingOperation);
         }
 
+        //! Largest number of queued one-way operations an async worker commits in one transaction, 1 disables it.
+        //! Has to be set before anything is queued.
+        void SetWriteBatchSize(uint32 size)
+        {
+            for (uint8 i = 0; i < _connectionCount[IDX_ASYNC]; ++i)
+                _connections[IDX_ASYNC][i]->m_worker->SetMaxBatchSize(std::max<uint32>(size, 1));
+        }
+
+        void GetAsyncStats(AsyncStats& stats)
+        {
+            stats.Queued = uint32(_queue->method_count());
+            stats.Operations = uint64(_asyncStats.Operations.value());
+            stats.Batches = uint64(_asyncStats.Batches.value());
+            stats.BatchedOperations = uint64(_asyncStats.BatchedOperations.value());
+            stats.Replayed = uint64(_asyncStats.Replayed.value());
+            stats.TotalQueueTime = uint64(_asyncStats.TotalQueueTime.value());
+            stats.MaxQueueTime = _asyncStats.MaxQueueTime;
+        }
+
+        void GetPoolStats(PoolStats& stats)
+        {
+            TRINITY_GUARD(ACE_Thread_Mutex, _poolLock);
+            stats = _stats;
+            stats.Waiting = uint32(_waiters.size());
+            stats.Connections = _connectionCount[IDX_SYNCH];
+        }
+
+        //! Statements that held the synchronous connections the longest in total
+        void GetTopHolders(std::vector<HolderStats>& holders, size_t count)
+        {
+            {
+                TRINITY_GUARD(ACE_Thread_Mutex, _poolLock);
+                holders.reserve(_holders.size());
+                for (typename HolderMap::const_iterator itr = _holders.begin(); itr != _holders.end(); ++itr)
+                {
+                    holders.push_back(itr->second);
+                    if (itr->first == SITE_TRANSACTION)
+                        holders.back().Query = "<transaction>";
+                    else if (itr->first != SITE_ADHOC && _connectionCount[IDX_SYNCH])
+                    {
+                        PreparedStatementMap const& queries = _connections[IDX_SYNCH][0]->m_queries;
+                        PreparedStatementMap::const_iterator query = queries.find(itr->first);
+                        if (query != queries.end())
+                            holders.back().Query = query->second.first;
+                    }
+                }
+            }
+
+            std::sort(holders.begin(), holders.end(), HolderTimeGreater());
+            if (holders.size() > count)
+                holders.resize(count);
+        }
+
     private:
+        //! Call sites of the synchronous connections that are not prepared statements
+        enum HolderSite
+        {
+            SITE_ADHOC          = 0xFFFFFFFF,
+            SITE_TRANSACTION    = 0xFFFFFFFE
+        };
+
+        struct HolderTimeGreater
+        {
+            bool operator()(HolderStats const& left, HolderStats const& right) const
+            {
+                return left.TotalHoldTime > right.TotalHoldTime;
+            }
+        };
+
+        //! Caller of GetFreeConnection, woken up when a connection is handed to it
+        struct ConnectionWaiter
+        {
+            ConnectionWaiter(ACE_Thread_Mutex& lock) : Condition(lock), Connection(NULL) { }
+
+            ACE_Condition_Thread_Mutex Condition;
+            T* Connection;
+        };
+
+        typedef std::map<uint32, HolderStats> HolderMap;
+
+        static uint64 GetTimeUS()
+        {
+            ACE_UINT64 time;
+            ACE_OS::gettimeofday().to_usec(time);
+            return uint64(time);
+        }
+
         unsigned long EscapeString(char *to, const char *from, unsigned long length)
         {
             if (!to || !from || !length)
@@ -481,26 +636,96 @@ class DatabaseWorkerPool
 
         void Enqueue(SQLOperation* op)
         {
+            op->m_queueTime = getMSTime();
             _queue->enqueue(op);
         }
 
-        //! Gets a free connection in the synchronous connection pool.
-        //! Caller MUST call t->Unlock() after touching the MySQL context to prevent deadlocks.
-        T* GetFreeConnection()
+        //! Gets a free connection in the synchronous connection pool, the callers get them in the order they asked.
+        //! Waits at most timeout milliseconds, or forever with 0, and returns NULL when it expired.
+        //! Caller MUST call ReleaseConnection() after touching the MySQL context to prevent deadlocks.
+        T* GetFreeConnection(uint64& acquireTime, uint32 timeout = 0)
         {
-            uint8 i = 0;
-            size_t num_cons = _connectionCount[IDX_SYNCH];
-            //! Block forever until a connection is free
-            for (;;)
+            uint64 startTime = GetTimeUS();
+
+            TRINITY_GUARD(ACE_Thread_Mutex, _poolLock);
+
+            T* t = NULL;
+            if (_waiters.empty() && !_freeConnections.empty())
             {
-                T* t = _connections[IDX_SYNCH][++i % num_cons];
-                //! Must be matched with t->Unlock() or you will get deadlocks
-                if (t->LockIfReady())
-                    return t;
+                t = _freeConnections.front();
+                _freeConnections.pop_front();
             }
+            else
+            {
+                ++_stats.Contended;
+
+                ConnectionWaiter waiter(_poolLock);
+                _waiters.push_back(&waiter);
+
+                ACE_Time_Value deadline = ACE_OS::gettimeofday() + ACE_Time_Value(timeout / IN_MILLISECONDS, (timeout % IN_MILLISECONDS) * 1000);
+                while (!waiter.Connection)
+                    if (waiter.Condition.wait(timeout ? &deadline : NULL) == -1 && timeout && ACE_OS::gettimeofday() >= deadline)
+                        break;
+
+                if (!waiter.Connection)
+                {
+                    _waiters.erase(std::find(_waiters.begin(), _waiters.end(), &waiter));
+                    ++_stats.TimedOut;
+                    return NULL;
+                }
 
-            //! This will be called when Celine Dion learns to sing
-            return NULL;
+                t = waiter.Connection;
+            }
+
+            acquireTime = GetTimeUS();
+            uint32 waitTime = uint32(acquireTime - startTime);
+
+            ++_stats.Acquired;
+            _stats.TotalWaitTime += waitTime;
+            _stats.MaxWaitTime = std::max(_stats.MaxWaitTime, waitTime);
+            return t;
+        }
+
+        //! Gives back a connection got from GetFreeConnection, accounting its hold time to the statement
+        void ReleaseConnection(T* t, uint64 acquireTime, uint32 site, char const* sql = NULL)
+        {
+            uint32 holdTime = uint32(GetTimeUS() - acquireTime);
+
+            TRINITY_GUARD(ACE_Thread_Mutex, _poolLock);
+
+            _stats.TotalHoldTime += holdTime;
+            _stats.MaxHoldTime = std::max(_stats.MaxHoldTime, holdTime);
+
+            HolderStats& holder = _holders[site];
+            ++holder.Count;
+            holder.TotalHoldTime += holdTime;
+            if (holdTime >= holder.MaxHoldTime)
+            {
+                holder.MaxHoldTime = holdTime;
+                if (sql)
+                {
+                    holder.Query = sql;
+                    if (holder.Query.size() > 256)
+                        holder.Query.resize(256);
+                }
+            }
+
+            _ReturnConnection(t);
+        }
+
+        //! Hands the connection to the longest waiting caller, _poolLock must be held
+        void _ReturnConnection(T* t)
+        {
+            if (_waiters.empty())
+            {
+                _freeConnections.push_back(t);
+                return;
+            }
+
+            ConnectionWaiter* waiter = _waiters.front();
+            _waiters.pop_front();
+            waiter->Connection = t;
+            waiter->Condition.signal();
         }
 
         char const* GetDatabaseName() const
@@ -520,6 +745,13 @@ class DatabaseWorkerPool
         std::vector< std::vector<T*> >  _connections;
         uint32                          _connectionCount[2];       //! Counter of MySQL connections;
         MySQLConnectionInfo             _connectionInfo;
+        DatabaseWorkerStats             _asyncStats;        //! Shared by the async workers
+
+        ACE_Thread_Mutex                _poolLock;          //! Guards everything below
+        std::deque<T*>                  _freeConnections;   //! Idle synchronous connections, used in turn
+        std::deque<ConnectionWaiter*>   _waiters;
+        PoolStats                       _stats;
+        HolderMap                       _holders;
 };
 
 #endif
@@ -23,6 +23,8 @@
 
 #include <mysql.h>
 
+/// Typed view of one column of a result row. The value is not copied: it points into the
+/// row buffer of the ResultSet/PreparedResultSet, so it is only valid as long as that row is.
 class Field
 {
     friend class ResultSet;
@@ -243,7 +245,7 @@ class Field
                     string = "";
                 return std::string(string, data.length);
             }
-            return std::string((char*)data.value);
+            return std::string((char*)data.value, data.length);
         }
 
         bool IsNull() const
@@ -253,7 +255,6 @@ class Field
 
     protected:
         Field();
-        ~Field();
 
         #if defined(__GNUC__)
         #pragma pack(1)
@@ -262,8 +263,8 @@ class Field
         #endif
         struct
         {
-            uint32 length;          // Length (prepared strings only)
-            void* value;            // Actual data in memory
+            uint32 length;          // Length of strings
+            void* value;            // Data in the row buffer of the result set
             enum_field_types type;  // Field type
             bool raw;               // Raw bytes? (Prepared statement or ad hoc)
          } data;
@@ -273,14 +274,8 @@ class Field
         #pragma pack(pop)
         #endif
 
-        void SetByteValue(void const* newValue, size_t const newSize, enum_field_types newType, uint32 length);
-        void SetStructuredValue(char* newValue, enum_field_types newType);
-
-        void CleanUp()
-        {
-            delete[] ((char*)data.value);
-            data.value = NULL;
-        }
+        void SetByteValue(void* newValue, enum_field_types newType, uint32 length);
+        void SetStructuredValue(char* newValue, enum_field_types newType, uint32 length);
 
         static size_t SizeForType(MYSQL_FIELD* field)
         {
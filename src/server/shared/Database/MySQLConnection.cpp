@@ -37,6 +37,7 @@
 MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
+m_retryOnReconnect(true),
 m_queue(NULL),
 m_worker(NULL),
 m_Mysql(NULL),
@@ -48,6 +49,7 @@ m_connectionFlags(CONNECTION_SYNCH)
 MySQLConnection::MySQLConnection(ACE_Activation_Queue* queue, MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
+m_retryOnReconnect(true),
 m_queue(queue),
 m_Mysql(NULL),
 m_connectionInfo(connInfo),
@@ -358,12 +360,32 @@ void MySQLConnection::CommitTransaction()
 
 bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
 {
-    std::list<SQLElementData> const& queries = transaction->m_queries;
-    if (queries.empty())
+    if (transaction->m_queries.empty())
         return false;
 
     BeginTransaction();
 
+    if (!ExecuteTransactionQueries(transaction))
+    {
+        RollbackTransaction();
+        return false;
+    }
+
+    // we might encounter errors during certain queries, and depending on the kind of error
+    // we might want to restart the transaction. So to prevent data loss, we only clean up when it's all done.
+    // This is done in calling functions DatabaseWorkerPool<T>::DirectCommitTransaction and TransactionTask::Execute,
+    // and not while iterating over every element.
+
+    CommitTransaction();
+    return true;
+}
+
+bool MySQLConnection::ExecuteTransactionQueries(SQLTransaction& transaction)
+{
+    std::list<SQLElementData> const& queries = transaction->m_queries;
+    if (queries.empty())
+        return false;
+
     std::list<SQLElementData>::const_iterator itr;
     for (itr = queries.begin(); itr != queries.end(); ++itr)
     {
@@ -377,7 +399,6 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
                 if (!Execute(stmt))
                 {
                     sLog->outWarn(LOG_FILTER_SQL, "Transaction aborted. %u queries not executed.", (uint32)queries.size());
-                    RollbackTransaction();
                     return false;
                 }
             }
@@ -389,7 +410,6 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
                 if (!Execute(sql))
                 {
                     sLog->outWarn(LOG_FILTER_SQL, "Transaction aborted. %u queries not executed.", (uint32)queries.size());
-                    RollbackTransaction();
                     return false;
                 }
             }
@@ -397,12 +417,6 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
         }
     }
 
-    // we might encounter errors during certain queries, and depending on the kind of error
-    // we might want to restart the transaction. So to prevent data loss, we only clean up when it's all done.
-    // This is done in calling functions DatabaseWorkerPool<T>::DirectCommitTransaction and TransactionTask::Execute,
-    // and not while iterating over every element.
-
-    CommitTransaction();
     return true;
 }
 
@@ -417,6 +431,29 @@ MySQLPreparedStatement* MySQLConnection::GetPreparedStatement(uint32 index)
     return ret;
 }
 
+bool MySQLConnection::CommitsImplicitly(const char* sql)
+{
+    static char const* const keywords[] = { "ALTER", "CREATE", "DROP", "RENAME", "TRUNCATE", "LOCK", "UNLOCK", "GRANT", "REVOKE" };
+
+    while (*sql && isspace(*sql))
+        ++sql;
+
+    for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); ++i)
+    {
+        size_t length = strlen(keywords[i]);
+        if (!strnicmp(sql, keywords[i], length) && (!sql[length] || isspace(sql[length])))
+            return true;
+    }
+
+    return false;
+}
+
+bool MySQLConnection::CommitsImplicitly(uint32 index) const
+{
+    PreparedStatementMap::const_iterator itr = m_queries.find(index);
+    return itr != m_queries.end() && CommitsImplicitly(itr->second.first.c_str());
+}
+
 void MySQLConnection::PrepareStatement(uint32 index, const char* sql, ConnectionFlags flags)
 {
     m_queries.insert(PreparedStatementMap::value_type(index, std::make_pair(sql, flags)));
@@ -495,7 +532,7 @@ bool MySQLConnection::_HandleMySQLErrno(uint32 errNo)
                             (m_connectionFlags & CONNECTION_ASYNC) ? "asynchronous" : "synchronous");
 
                 m_reconnecting = false;
-                return true;
+                return m_retryOnReconnect;
             }
 
             uint32 lErrno = mysql_errno(GetHandle());   // It's possible this attempted reconnect throws 2006 at us. To prevent crazy recursive calls, sleep here.
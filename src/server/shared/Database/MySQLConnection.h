@@ -89,26 +89,22 @@ class MySQLConnection
         void RollbackTransaction();
         void CommitTransaction();
         bool ExecuteTransaction(SQLTransaction& transaction);
+        bool ExecuteTransactionQueries(SQLTransaction& transaction);  //! Without starting, committing or rolling back
 
         operator bool () const { return m_Mysql != NULL; }
         void Ping() { mysql_ping(m_Mysql); }
 
         uint32 GetLastError() { return mysql_errno(m_Mysql); }
+        uint64 GetThreadId() { return mysql_thread_id(m_Mysql); }  //! Changes when the connection was reestablished
 
-    protected:
-        bool LockIfReady()
-        {
-            /// Tries to acquire lock. If lock is acquired by another thread
-            /// the calling parent will just try another connection
-            return m_Mutex.tryacquire() != -1;
-        }
-
-        void Unlock()
-        {
-            /// Called by parent databasepool. Will let other threads access this connection
-            m_Mutex.release();
-        }
+        //! While disabled a statement interrupted by a reconnect fails instead of running again on the new connection
+        void SetRetryOnReconnect(bool retry) { m_retryOnReconnect = retry; }
+
+        //! Statements committing the open transaction by themselves (DDL, TRUNCATE, LOCK TABLES, ...)
+        static bool CommitsImplicitly(const char* sql);
+        bool CommitsImplicitly(uint32 index) const;
 
+    protected:
         MYSQL* GetHandle()  { return m_Mysql; }
         MySQLPreparedStatement* GetPreparedStatement(uint32 index);
         void PrepareStatement(uint32 index, const char* sql, ConnectionFlags flags);
@@ -121,6 +117,7 @@ class MySQLConnection
         PreparedStatementMap                 m_queries;       //! Query storage
         bool                                 m_reconnecting;  //! Are we reconnecting?
         bool                                 m_prepareError;  //! Was there any error while preparing statements?
+        bool                                 m_retryOnReconnect; //! Run the failed statement again after reconnecting?
 
     private:
         bool _HandleMySQLErrno(uint32 errNo);
@@ -131,7 +128,6 @@ class MySQLConnection
         MYSQL *               m_Mysql;                      //! MySQL Handle.
         MySQLConnectionInfo&  m_connectionInfo;             //! Connection info (used for logging)
         ConnectionFlags       m_connectionFlags;            //! Connection flags (for preparing relevant statements)
-        ACE_Thread_Mutex      m_Mutex;
 };
 
 #endif
@@ -467,6 +467,11 @@ PreparedStatementTask::~PreparedStatementTask()
     delete m_stmt;
 }
 
+bool PreparedStatementTask::IsBatchable(MySQLConnection* conn) const
+{
+    return !m_has_result && !conn->CommitsImplicitly(m_stmt->GetIndex());
+}
+
 bool PreparedStatementTask::Execute()
 {
     if (m_has_result)
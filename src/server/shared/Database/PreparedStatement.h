@@ -80,6 +80,8 @@ class PreparedStatement
         explicit PreparedStatement(uint32 index);
         ~PreparedStatement();
 
+        uint32 GetIndex() const { return m_index; }
+
         void setBool(const uint8 index, const bool value);
         void setUInt8(const uint8 index, const uint8 value);
         void setUInt16(const uint8 index, const uint16 value);
@@ -158,6 +160,7 @@ class PreparedStatementTask : public SQLOperation
         ~PreparedStatementTask();
 
         bool Execute();
+        bool IsBatchable(MySQLConnection* conn) const;
 
     protected:
         PreparedStatement* m_stmt;
@@ -30,6 +30,7 @@ _fields(fields)
 }
 
 PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES *result, uint64 rowCount, uint32 fieldCount) :
+m_rows(NULL),
 m_rowCount(rowCount),
 m_rowPosition(0),
 m_fieldCount(fieldCount),
@@ -37,10 +38,14 @@ m_rBind(NULL),
 m_stmt(stmt),
 m_res(result),
 m_isNull(NULL),
-m_length(NULL)
+m_length(NULL),
+m_arena(NULL)
 {
     if (!m_res)
+    {
+        m_rowCount = 0;
         return;
+    }
 
     if (m_stmt->bind_result_done)
     {
@@ -60,19 +65,25 @@ m_length(NULL)
     if (mysql_stmt_store_result(m_stmt))
     {
         sLog->outWarn(LOG_FILTER_SQL, "%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+        m_rowCount = 0;
         return;
     }
 
-    //- This is where we prepare the buffer based on metadata
+    m_rowCount = mysql_stmt_num_rows(m_stmt);
+
+    //- This is where we lay out a row based on metadata, every value 8 byte aligned
+    std::vector<size_t> offsets(m_fieldCount);
+    size_t rowSize = 0;
     uint32 i = 0;
     MYSQL_FIELD* field = mysql_fetch_field(m_res);
     while (field)
     {
         size_t size = Field::SizeForType(field);
 
+        offsets[i] = rowSize;
+        rowSize += (size + 7) & ~size_t(7);
+
         m_rBind[i].buffer_type = field->type;
-        m_rBind[i].buffer = malloc(size);
-        memset(m_rBind[i].buffer, 0, size);
         m_rBind[i].buffer_length = size;
         m_rBind[i].length = &m_length[i];
         m_rBind[i].is_null = &m_isNull[i];
@@ -83,6 +94,15 @@ m_length(NULL)
         field = mysql_fetch_field(m_res);
     }
 
+    //- One allocation holds the fields of every row and the values they point to
+    size_t fieldsSize = (sizeof(Field) * m_fieldCount * size_t(m_rowCount) + 7) & ~size_t(7);
+    m_arena = new char[fieldsSize + rowSize * size_t(m_rowCount)];
+    m_rows = reinterpret_cast<Field*>(m_arena);
+
+    char* rowData = m_arena + fieldsSize;
+    for (i = 0; i < m_fieldCount; ++i)
+        m_rBind[i].buffer = rowData + offsets[i];
+
     //- This is where we bind the bind the buffer to the statement
     if (mysql_stmt_bind_result(m_stmt, m_rBind))
     {
@@ -90,22 +110,40 @@ m_length(NULL)
         delete[] m_rBind;
         delete[] m_isNull;
         delete[] m_length;
+        m_rowCount = 0;
         return;
     }
 
-    m_rowCount = mysql_stmt_num_rows(m_stmt);
-
-    m_rows.resize(uint32(m_rowCount));
+    //- Every row is fetched straight into its place in the arena, the fields only point at it
     while (_NextRow())
     {
-        m_rows[uint32(m_rowPosition)] = new Field[m_fieldCount];
-        for (uint64 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
+        Field* row = &m_rows[size_t(m_rowPosition) * m_fieldCount];
+        for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
         {
-            if (!*m_rBind[fIndex].is_null)
-                m_rows[uint32(m_rowPosition)][fIndex].SetByteValue( m_rBind[fIndex].buffer,
-                                                            m_rBind[fIndex].buffer_length,
-                                                            m_rBind[fIndex].buffer_type,
-                                                           *m_rBind[fIndex].length );
+            Field* value = new (&row[fIndex]) Field();
+
+            if (!m_isNull[fIndex])
+            {
+                //- The arena is not zeroed and the server does not terminate strings, GetCString relies on it
+                switch (m_rBind[fIndex].buffer_type)
+                {
+                    case MYSQL_TYPE_TINY_BLOB:
+                    case MYSQL_TYPE_MEDIUM_BLOB:
+                    case MYSQL_TYPE_LONG_BLOB:
+                    case MYSQL_TYPE_BLOB:
+                    case MYSQL_TYPE_STRING:
+                    case MYSQL_TYPE_VAR_STRING:
+                    case MYSQL_TYPE_DECIMAL:
+                    case MYSQL_TYPE_NEWDECIMAL:
+                        if (m_rBind[fIndex].buffer_length)
+                            static_cast<char*>(m_rBind[fIndex].buffer)[std::min<unsigned long>(m_length[fIndex], m_rBind[fIndex].buffer_length - 1)] = '\0';
+                        break;
+                    default:
+                        break;
+                }
+
+                value->SetByteValue(m_rBind[fIndex].buffer, m_rBind[fIndex].buffer_type, uint32(m_length[fIndex]));
+            }
             else
                 switch (m_rBind[fIndex].buffer_type)
                 {
@@ -115,20 +153,29 @@ m_length(NULL)
                     case MYSQL_TYPE_BLOB:
                     case MYSQL_TYPE_STRING:
                     case MYSQL_TYPE_VAR_STRING:
-                    m_rows[uint32(m_rowPosition)][fIndex].SetByteValue( "",
-                                                            m_rBind[fIndex].buffer_length,
-                                                            m_rBind[fIndex].buffer_type,
-                                                           *m_rBind[fIndex].length );
-                    break;
+                        value->SetByteValue(const_cast<char*>(""), m_rBind[fIndex].buffer_type, 0);
+                        break;
                     default:
-                    m_rows[uint32(m_rowPosition)][fIndex].SetByteValue( 0,
-                                                            m_rBind[fIndex].buffer_length,
-                                                            m_rBind[fIndex].buffer_type,
-                                                           *m_rBind[fIndex].length );
+                        value->SetByteValue(NULL, m_rBind[fIndex].buffer_type, 0);
+                        break;
                 }
         }
-        m_rowPosition++;
+
+        if (++m_rowPosition >= m_rowCount)
+            break;
+
+        rowData += rowSize;
+        for (uint32 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
+            m_rBind[fIndex].buffer = rowData + offsets[fIndex];
+
+        if (mysql_stmt_bind_result(m_stmt, m_rBind))
+        {
+            sLog->outWarn(LOG_FILTER_SQL, "%s:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+            break;
+        }
     }
+
+    m_rowCount = m_rowPosition;
     m_rowPosition = 0;
 
     /// All data is buffered, let go of mysql c api structures
@@ -142,8 +189,7 @@ ResultSet::~ResultSet()
 
 PreparedResultSet::~PreparedResultSet()
 {
-    for (uint32 i = 0; i < uint32(m_rowCount); ++i)
-        delete[] m_rows[i];
+    delete[] m_arena;
 }
 
 bool ResultSet::NextRow()
@@ -160,8 +206,10 @@ bool ResultSet::NextRow()
         return false;
     }
 
+    // the fields point into the row, which stays valid until the next fetch
+    unsigned long* lengths = mysql_fetch_lengths(_result);
     for (uint32 i = 0; i < _fieldCount; i++)
-        _currentRow[i].SetStructuredValue(row[i], _fields[i].type);
+        _currentRow[i].SetStructuredValue(row[i], _fields[i].type, uint32(lengths[i]));
 
     return true;
 }
@@ -215,14 +263,7 @@ void PreparedResultSet::CleanUp()
     if (m_res)
         mysql_free_result(m_res);
 
-    FreeBindBuffer();
     mysql_stmt_free_result(m_stmt);
 
     delete[] m_rBind;
 }
-
-void PreparedResultSet::FreeBindBuffer()
-{
-    for (uint32 i = 0; i < m_fieldCount; ++i)
-        free (m_rBind[i].buffer);
-}
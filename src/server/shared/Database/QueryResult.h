@@ -72,18 +72,18 @@ class PreparedResultSet
         Field* Fetch() const
         {
             ASSERT(m_rowPosition < m_rowCount);
-            return m_rows[uint32(m_rowPosition)];
+            return &m_rows[size_t(m_rowPosition) * m_fieldCount];
         }
 
         const Field & operator [] (uint32 index) const
         {
             ASSERT(m_rowPosition < m_rowCount);
             ASSERT(index < m_fieldCount);
-            return m_rows[uint32(m_rowPosition)][index];
+            return m_rows[size_t(m_rowPosition) * m_fieldCount + index];
         }
 
     protected:
-        std::vector<Field*> m_rows;
+        Field* m_rows;                                      // m_fieldCount fields per row, in m_arena
         uint64 m_rowCount;
         uint64 m_rowPosition;
         uint32 m_fieldCount;
@@ -96,7 +96,8 @@ class PreparedResultSet
         my_bool* m_isNull;
         unsigned long* m_length;
 
-        void FreeBindBuffer();
+        char* m_arena;                                      // the fields followed by the values of every row
+
         void CleanUp();
         bool _NextRow();
 
@@ -59,7 +59,7 @@ class MySQLConnection;
 class SQLOperation : public ACE_Method_Request
 {
     public:
-        SQLOperation(): m_conn(NULL) {};
+        SQLOperation(): m_conn(NULL), m_queueTime(0) {};
         virtual int call()
         {
             Execute();
@@ -68,7 +68,14 @@ class SQLOperation : public ACE_Method_Request
         virtual bool Execute() = 0;
         virtual void SetConnection(MySQLConnection* con) { m_conn = con; }
 
+        //! One-way operations the worker may commit together with the ones queued behind them, see DatabaseWorker::_ExecuteBatch.
+        //! Statements committing implicitly are left out, a lost batch would apply them twice.
+        virtual bool IsBatchable(MySQLConnection* /*conn*/) const { return false; }
+        //! Runs the operation inside the transaction of the batch, it must not begin or commit one itself
+        virtual bool ExecuteInBatch() { return Execute(); }
+
         MySQLConnection* m_conn;
+        uint32 m_queueTime;                                 //! getMSTime() when it was enqueued
 };
 
 #endif
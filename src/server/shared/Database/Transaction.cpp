@@ -17,6 +17,7 @@
 
 #include "DatabaseEnv.h"
 #include "Transaction.h"
+#include <mysqld_error.h>
 
 //- Append a raw ad-hoc query to the transaction
 void Transaction::Append(const char* sql)
@@ -90,3 +91,40 @@ bool TransactionTask::Execute()
 
     return false;
 }
+
+bool TransactionTask::IsBatchable(MySQLConnection* conn) const
+{
+    for (std::list<SQLElementData>::const_iterator itr = m_trans->m_queries.begin(); itr != m_trans->m_queries.end(); ++itr)
+    {
+        bool commits = itr->type == SQL_ELEMENT_PREPARED ? conn->CommitsImplicitly(itr->element.stmt->GetIndex()) :
+            MySQLConnection::CommitsImplicitly(itr->element.query);
+        if (commits)
+            return false;
+    }
+
+    return true;
+}
+
+bool TransactionTask::ExecuteInBatch()
+{
+    uint64 threadId = m_conn->GetThreadId();
+
+    // the other operations of the batch stay when only this transaction fails
+    m_conn->Execute("SAVEPOINT batch_transaction");
+
+    // the batch transaction is gone with the old connection, the queries must neither run in
+    // autocommit now nor be freed, the worker replays them through Execute()
+    if (m_conn->GetThreadId() != threadId)
+        return false;
+
+    if (m_conn->ExecuteTransactionQueries(m_trans))
+        return true;
+
+    // the whole batch was rolled back or lost with the connection, the worker runs this through Execute() again
+    if (m_conn->GetLastError() == ER_LOCK_DEADLOCK || m_conn->GetThreadId() != threadId)
+        return false;
+
+    m_conn->Execute("ROLLBACK TO SAVEPOINT batch_transaction");
+    m_trans->Cleanup();
+    return false;
+}
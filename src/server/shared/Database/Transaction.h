@@ -64,6 +64,8 @@ class TransactionTask : public SQLOperation
 
     protected:
         bool Execute();
+        bool IsBatchable(MySQLConnection* conn) const;
+        bool ExecuteInBatch();
 
         SQLTransaction m_trans;
 };
@@ -126,6 +126,13 @@ class ByteBuffer
             _bitpos = 8;
         }
 
+        // drops the partial byte of ReadBit/WriteBit, e.g. when the buffer is reused
+        void ResetBitPos()
+        {
+            _curbitval = 0;
+            _bitpos = 8;
+        }
+
         bool WriteBit(uint32 bit)
         {
             --_bitpos;
@@ -537,6 +544,8 @@ class ByteBuffer
             _wpos = size();
         }
 
+        size_t capacity() const { return _storage.capacity(); }
+
         void reserve(size_t ressize)
         {
             if (ressize > size())
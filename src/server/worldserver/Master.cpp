@@ -399,6 +399,8 @@ bool Master::_StartDB()
         return false;
     }
 
+    CharacterDatabase.SetWriteBatchSize(uint32(std::max(ConfigMgr::GetIntDefault("CharacterDatabase.WriteBatchSize", 64), 1)));
+
     ///- Get login database info from configuration file
     dbstring = ConfigMgr::GetStringDefault("LoginDatabaseInfo", "");
     if (dbstring.empty())
@@ -32,6 +32,7 @@
 #include "WorldRunnable.h"
 #include "OutdoorPvPMgr.h"
 #include "InfoMgr.h"
+#include "GuildMgr.h"
 
 #define WORLD_SLEEP_CONST 50
 
@@ -87,11 +88,18 @@ void WorldRunnable::run()
     sWorld->KickAll();                                       // save and kick all players
     sWorld->UpdateSessions( 1 );                             // real players unload required UpdateSessions call
 
+    // guild data is written by sweeps over several world updates, finish the running one and
+    // write what changed since in one go
+    sGuildMgr->UpdateSaveSweep(0);
+    sGuildMgr->SaveGuilds();
+    sGuildMgr->UpdateSaveSweep(0);
+
     // unload battleground templates before different singletons destroyed
     sBattlegroundMgr->DeleteAllBattlegrounds();
 
     sWorldSocketMgr->StopNetwork();
 
+    sWorld->StopUpdateThreads();
     sMapMgr->UnloadAll();                     // unload all grids (including locked in memory)
     sObjectAccessor->UnloadAll();             // unload 'i_player2corpse' storage and remove from world
     sScriptMgr->Unload();